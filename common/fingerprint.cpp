@@ -0,0 +1,113 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "fingerprint.h"
+
+#include <disman/config.h>
+#include <disman/mode.h>
+#include <disman/output.h>
+
+#include <cmath>
+#include <string>
+
+namespace Fingerprint
+{
+
+static uint64_t mix(uint64_t hash, uint64_t value)
+{
+    // The splitmix64 finalizer over the running hash and the next value.
+    hash += value + 0x9e3779b97f4a7c15;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111eb;
+    return hash ^ (hash >> 31);
+}
+
+static uint64_t mix(uint64_t hash, std::string const& value)
+{
+    // FNV-1a, then mixed in like any other value.
+    uint64_t string = 0xcbf29ce484222325;
+    for (auto const c : value) {
+        string ^= static_cast<uint8_t>(c);
+        string *= 0x100000001b3;
+    }
+    return mix(hash, string);
+}
+
+static uint64_t mix(uint64_t hash, double value)
+{
+    // Rounded so that values which differ only by floating point noise are equal.
+    return mix(hash, static_cast<uint64_t>(std::llround(value * 1000)));
+}
+
+static uint64_t combine(int outputId, uint64_t output)
+{
+    return mix(static_cast<uint64_t>(outputId), output);
+}
+
+uint64_t output(Disman::OutputPtr const& output)
+{
+    if (!output) {
+        return 0;
+    }
+
+    auto hash = mix(0, uint64_t(output->enabled()));
+    if (!output->enabled()) {
+        return hash;
+    }
+
+    if (auto const mode = output->auto_mode()) {
+        hash = mix(hash, mode->id());
+    }
+    hash = mix(hash, output->position().x());
+    hash = mix(hash, output->position().y());
+    hash = mix(hash, output->scale());
+    hash = mix(hash, static_cast<uint64_t>(output->rotation()));
+    hash = mix(hash, uint64_t(output->adaptive_sync()));
+    hash = mix(hash, static_cast<uint64_t>(output->replication_source()));
+    hash = mix(hash, static_cast<uint64_t>(output->retention()));
+
+    uint64_t const flags = uint64_t(output->auto_resolution())
+        | uint64_t(output->auto_refresh_rate()) << 1 | uint64_t(output->auto_rotate()) << 2
+        | uint64_t(output->auto_rotate_only_in_tablet_mode()) << 3;
+    return mix(hash, flags);
+}
+
+static int primaryId(Disman::ConfigPtr const& config)
+{
+    if (!(config->supported_features() & Disman::Config::Feature::PrimaryDisplay)) {
+        return 0;
+    }
+    auto const primary = config->primary_output();
+    return primary ? primary->id() : 0;
+}
+
+uint64_t config(Disman::ConfigPtr const& config)
+{
+    if (!config) {
+        return 0;
+    }
+
+    // Summing makes it independent of the order.
+    uint64_t sum = 0;
+    for (auto const& [id, output] : config->outputs()) {
+        sum += combine(id, Fingerprint::output(output));
+    }
+    return mix(sum, static_cast<uint64_t>(primaryId(config)));
+}
+
+uint64_t setup(Disman::ConfigPtr const& config)
+{
+    if (!config) {
+        return 0;
+    }
+
+    uint64_t sum = 0;
+    for (auto const& [id, output] : config->outputs()) {
+        sum += mix(0, output->hash());
+    }
+    return mix(sum, static_cast<uint64_t>(config->outputs().size()));
+}
+
+}
@@ -0,0 +1,35 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <disman/types.h>
+
+#include <cstdint>
+
+/**
+ * 64-bit fingerprints of the settings a layout consists of, for cheap equality checks and as
+ * cache keys.
+ *
+ * An output fingerprint covers its enabled state and, when enabled, mode, position, scale,
+ * rotation, adaptive sync, replication source, retention and the auto flags. It does not cover
+ * the output id, so outputs of two configs can be compared after matching them by hash().
+ *
+ * A config fingerprint combines the output fingerprints with their ids independent of the order
+ * of the outputs, plus the primary output where the backend supports one.
+ */
+namespace Fingerprint
+{
+
+uint64_t output(Disman::OutputPtr const& output);
+uint64_t config(Disman::ConfigPtr const& config);
+
+/**
+ * Covers only which outputs are connected, by their hash() and independent of their settings and
+ * ids. Equal for all layouts of the same set of outputs.
+ */
+uint64_t setup(Disman::ConfigPtr const& config);
+
+}
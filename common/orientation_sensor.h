@@ -19,18 +19,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QObject>
 #include <QOrientationReading>
 
-class OrientationSensor final : public QObject
+/**
+ * The device orientation from Qt Sensors. Tests can replace it with a subclass that reports
+ * readings of their own.
+ */
+class OrientationSensor : public QObject
 {
     Q_OBJECT
 public:
     explicit OrientationSensor(QObject* parent = nullptr);
-    ~OrientationSensor() override final;
+    ~OrientationSensor() override;
 
-    QOrientationReading::Orientation value() const;
-    bool available() const;
-    bool enabled() const;
+    virtual QOrientationReading::Orientation value() const;
+    virtual bool available() const;
+    virtual bool enabled() const;
 
-    void setEnabled(bool enable);
+    virtual void setEnabled(bool enable);
 
 Q_SIGNALS:
     void valueChanged(QOrientationReading::Orientation orientation);
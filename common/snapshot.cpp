@@ -0,0 +1,350 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "snapshot.h"
+
+#include "fingerprint.h"
+
+#include <disman/config.h>
+#include <disman/mode.h>
+#include <disman/output.h>
+
+#include <QString>
+
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Snapshot
+{
+
+static constexpr char magic[4] = {'K', 'D', 'S', 'S'};
+
+QByteArray serialize(Disman::ConfigPtr const& config, uint64_t generation)
+{
+    std::decay_t<decltype(config->outputs())> outputs;
+    if (config) {
+        outputs = config->outputs();
+    }
+    auto const primary = config && (config->supported_features()
+                                    & Disman::Config::Feature::PrimaryDisplay)
+        ? config->primary_output()
+        : nullptr;
+
+    QByteArray strings;
+    auto const addString = [&strings](std::string const& value) {
+        String const string{static_cast<uint32_t>(strings.size()),
+                            static_cast<uint32_t>(value.size())};
+        strings.append(value.data(), value.size());
+        return string;
+    };
+
+    std::vector<Output> records;
+    records.reserve(outputs.size());
+    for (auto const& [id, output] : outputs) {
+        Output record{};
+        record.id = id;
+        record.flags = (output->enabled() ? Enabled : 0) | (output == primary ? Primary : 0)
+            | (output->adaptive_sync() ? AdaptiveSync : 0)
+            | (output->auto_resolution() ? AutoResolution : 0)
+            | (output->auto_refresh_rate() ? AutoRefreshRate : 0)
+            | (output->auto_rotate() ? AutoRotate : 0)
+            | (output->auto_rotate_only_in_tablet_mode() ? AutoRotateOnlyInTabletMode : 0);
+        record.type = static_cast<int32_t>(output->type());
+        record.rotation = static_cast<int32_t>(output->rotation());
+        record.replicationSource = output->replication_source();
+        record.retention = static_cast<int32_t>(output->retention());
+
+        if (auto const mode = output->auto_mode()) {
+            record.modeWidth = mode->size().width();
+            record.modeHeight = mode->size().height();
+            record.modeRefresh = static_cast<int32_t>(mode->refresh());
+            record.modeId = addString(mode->id());
+        }
+
+        auto const geometry = output->geometry();
+        record.x = geometry.x();
+        record.y = geometry.y();
+        record.width = geometry.width();
+        record.height = geometry.height();
+        record.scale = output->scale();
+
+        record.name = addString(output->name());
+        record.description = addString(output->description());
+        record.hash = addString(output->hash());
+        records.push_back(record);
+    }
+
+    auto const recordsSize = records.size() * sizeof(Output);
+
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.generation = generation;
+    header.fingerprint = Fingerprint::config(config);
+    header.size = static_cast<uint32_t>(sizeof(Header) + recordsSize + strings.size());
+    header.outputCount = static_cast<uint32_t>(records.size());
+    header.primaryId = primary ? primary->id() : 0;
+
+    QByteArray data;
+    data.reserve(header.size);
+    data.append(reinterpret_cast<char const*>(&header), sizeof(Header));
+    data.append(reinterpret_cast<char const*>(records.data()), recordsSize);
+    data.append(strings);
+    return data;
+}
+
+Disman::ConfigPtr toConfig(View const& view)
+{
+    if (!view.isValid()) {
+        return nullptr;
+    }
+
+    auto config = std::make_shared<Disman::Config>();
+    std::decay_t<decltype(config->outputs())> outputs;
+    Disman::OutputPtr primary;
+
+    for (int index = 0; index < view.outputCount(); index++) {
+        auto const& record = view.output(index);
+        auto output = std::make_shared<Disman::Output>();
+        output->set_id(record.id);
+        output->set_name(std::string(view.string(record.name)));
+        output->set_description(std::string(view.string(record.description)));
+        output->set_hash(std::string(view.string(record.hash)));
+        output->set_type(static_cast<Disman::Output::Type>(record.type));
+
+        if (record.modeWidth > 0) {
+            auto mode = std::make_shared<Disman::Mode>();
+            mode->set_id(std::string(view.string(record.modeId)));
+            mode->set_size(view.modeSize(record));
+            mode->set_refresh(record.modeRefresh);
+            output->set_modes({{mode->id(), mode}});
+            output->set_mode(mode);
+        }
+
+        output->set_enabled(record.flags & Enabled);
+        output->set_position(QPointF(record.x, record.y));
+        output->set_scale(record.scale);
+        output->set_rotation(static_cast<Disman::Output::Rotation>(record.rotation));
+        output->set_replication_source(record.replicationSource);
+        output->set_retention(static_cast<Disman::Output::Retention>(record.retention));
+        output->set_adaptive_sync(record.flags & AdaptiveSync);
+        output->set_auto_resolution(record.flags & AutoResolution);
+        output->set_auto_refresh_rate(record.flags & AutoRefreshRate);
+        output->set_auto_rotate(record.flags & AutoRotate);
+        output->set_auto_rotate_only_in_tablet_mode(record.flags & AutoRotateOnlyInTabletMode);
+
+        if (record.flags & Primary) {
+            primary = output;
+        }
+        outputs.emplace(record.id, output);
+    }
+
+    config->set_outputs(outputs);
+    if (primary) {
+        config->set_supported_features(Disman::Config::Feature::PrimaryDisplay);
+        config->set_primary_output(primary);
+    }
+    return config;
+}
+
+View::View(char const* data, std::size_t size)
+{
+    if (!data || size < sizeof(Header)
+        || reinterpret_cast<std::uintptr_t>(data) % alignof(Output) != 0) {
+        return;
+    }
+
+    auto const header = reinterpret_cast<Header const*>(data);
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version
+        || header->size > size) {
+        return;
+    }
+
+    auto const stringsStart = sizeof(Header) + std::size_t(header->outputCount) * sizeof(Output);
+    if (stringsStart > header->size) {
+        return;
+    }
+
+    auto const records = reinterpret_cast<Output const*>(data + sizeof(Header));
+    auto const stringsSize = header->size - stringsStart;
+    auto const inBounds = [stringsSize](String const& string) {
+        return std::size_t(string.offset) + string.length <= stringsSize;
+    };
+    for (uint32_t index = 0; index < header->outputCount; index++) {
+        auto const& record = records[index];
+        if (!inBounds(record.name) || !inBounds(record.description) || !inBounds(record.hash)
+            || !inBounds(record.modeId)) {
+            return;
+        }
+    }
+
+    m_data = data;
+    m_size = header->size;
+}
+
+bool View::isValid() const
+{
+    return m_data;
+}
+
+Header const* View::header() const
+{
+    return reinterpret_cast<Header const*>(m_data);
+}
+
+uint64_t View::generation() const
+{
+    return m_data ? header()->generation : 0;
+}
+
+uint64_t View::fingerprint() const
+{
+    return m_data ? header()->fingerprint : 0;
+}
+
+int View::primaryId() const
+{
+    return m_data ? header()->primaryId : 0;
+}
+
+int View::outputCount() const
+{
+    return m_data ? static_cast<int>(header()->outputCount) : 0;
+}
+
+Output const& View::output(int index) const
+{
+    Q_ASSERT(index >= 0 && index < outputCount());
+    return reinterpret_cast<Output const*>(m_data + sizeof(Header))[index];
+}
+
+Output const* View::outputById(int id) const
+{
+    for (int index = 0; index < outputCount(); index++) {
+        if (output(index).id == id) {
+            return &output(index);
+        }
+    }
+    return nullptr;
+}
+
+std::string_view View::string(String const& string) const
+{
+    auto const strings = m_data + sizeof(Header) + header()->outputCount * sizeof(Output);
+    return std::string_view(strings + string.offset, string.length);
+}
+
+QString View::qstring(String const& string) const
+{
+    auto const value = this->string(string);
+    return QString::fromUtf8(value.data(), static_cast<qsizetype>(value.size()));
+}
+
+QRectF View::geometry(Output const& output) const
+{
+    return QRectF(output.x, output.y, output.width, output.height);
+}
+
+QSize View::modeSize(Output const& output) const
+{
+    return QSize(output.modeWidth, output.modeHeight);
+}
+
+int createSealedFd(QByteArray const& data)
+{
+    auto const fd = memfd_create("kdisplay-snapshot", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        return -1;
+    }
+
+    qsizetype written = 0;
+    while (written < data.size()) {
+        auto const count = write(fd, data.constData() + written, data.size() - written);
+        if (count < 0) {
+            close(fd);
+            return -1;
+        }
+        written += count;
+    }
+
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+Mapping::Mapping(int fd)
+{
+    // Without the seals the sender could change or truncate the file while it is read.
+    // Files that don't support sealing at all, like regular ones, fail with -1.
+    auto const seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE;
+    if (fd < 0) {
+        return;
+    }
+    auto const present = fcntl(fd, F_GET_SEALS);
+    if (present < 0 || (present & seals) != seals) {
+        return;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        return;
+    }
+
+    auto const address = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        return;
+    }
+    m_address = address;
+    m_size = info.st_size;
+    m_view = View(static_cast<char const*>(m_address), m_size);
+}
+
+Mapping::~Mapping()
+{
+    unmap();
+}
+
+Mapping::Mapping(Mapping&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+Mapping& Mapping::operator=(Mapping&& other) noexcept
+{
+    if (this != &other) {
+        unmap();
+        m_address = std::exchange(other.m_address, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_view = std::exchange(other.m_view, View());
+    }
+    return *this;
+}
+
+View const& Mapping::view() const
+{
+    return m_view;
+}
+
+void Mapping::unmap()
+{
+    if (m_address) {
+        munmap(m_address, m_size);
+    }
+    m_address = nullptr;
+    m_size = 0;
+    m_view = View();
+}
+
+}
@@ -0,0 +1,171 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <disman/types.h>
+
+#include <QByteArray>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * A compact read-only serialization of a config that the daemon publishes for other processes.
+ *
+ * The buffer is a header, one fixed-size record per output and the strings the records point
+ * at. It is read in place, so it can be shared through a sealed memfd that clients map instead
+ * of fetching and copying the config from the backend themselves. The generation goes up with
+ * every layout the daemon publishes.
+ */
+namespace Snapshot
+{
+
+constexpr uint32_t version = 1;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t generation;
+    uint64_t fingerprint;
+    uint32_t size;
+    uint32_t outputCount;
+    int32_t primaryId;
+    uint32_t reserved;
+};
+
+enum OutputFlag : uint32_t {
+    Enabled = 1 << 0,
+    Primary = 1 << 1,
+    AdaptiveSync = 1 << 2,
+    AutoResolution = 1 << 3,
+    AutoRefreshRate = 1 << 4,
+    AutoRotate = 1 << 5,
+    AutoRotateOnlyInTabletMode = 1 << 6,
+};
+
+/**
+ * A string in the string table following the output records.
+ */
+struct String {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct Output {
+    int32_t id;
+    uint32_t flags;
+    int32_t type;
+    int32_t rotation;
+    int32_t replicationSource;
+    int32_t retention;
+    // The current mode, all zero when there is none.
+    int32_t modeWidth;
+    int32_t modeHeight;
+    int32_t modeRefresh;
+    uint32_t reserved;
+    double x;
+    double y;
+    double width;
+    double height;
+    double scale;
+    String name;
+    String description;
+    String hash;
+    String modeId;
+};
+
+static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 40);
+static_assert(std::is_trivially_copyable_v<Output> && sizeof(Output) == 112);
+
+QByteArray serialize(Disman::ConfigPtr const& config, uint64_t generation);
+
+class View;
+
+/**
+ * Builds a config from a snapshot to show before the real one is fetched. Its outputs only have
+ * their current mode and it must not be applied. Returns null for an invalid view.
+ */
+Disman::ConfigPtr toConfig(View const& view);
+
+/**
+ * Reads a serialized snapshot in place. The data must outlive the view.
+ */
+class View
+{
+public:
+    View() = default;
+    /**
+     * Checks the header and that all records and strings are in bounds. The view is invalid
+     * otherwise, for example for a snapshot of a different version.
+     */
+    View(char const* data, std::size_t size);
+
+    bool isValid() const;
+
+    uint64_t generation() const;
+    uint64_t fingerprint() const;
+    int primaryId() const;
+
+    int outputCount() const;
+    Output const& output(int index) const;
+    /**
+     * The record with @p id or null.
+     */
+    Output const* outputById(int id) const;
+
+    std::string_view string(String const& string) const;
+    QString qstring(String const& string) const;
+
+    QRectF geometry(Output const& output) const;
+    QSize modeSize(Output const& output) const;
+
+private:
+    Header const* header() const;
+
+    char const* m_data{nullptr};
+    std::size_t m_size{0};
+};
+
+/**
+ * Returns a sealed memfd holding @p data or -1 on failure. Readers can't change or resize it.
+ */
+int createSealedFd(QByteArray const& data);
+
+/**
+ * A read-only shared mapping of a snapshot file descriptor.
+ */
+class Mapping
+{
+public:
+    Mapping() = default;
+    /**
+     * Maps the file @p fd refers to, which must be sealed like createSealedFd does. The
+     * descriptor is not kept and can be closed afterwards.
+     */
+    explicit Mapping(int fd);
+    ~Mapping();
+
+    Mapping(Mapping const&) = delete;
+    Mapping& operator=(Mapping const&) = delete;
+    Mapping(Mapping&& other) noexcept;
+    Mapping& operator=(Mapping&& other) noexcept;
+
+    View const& view() const;
+
+private:
+    void unmap();
+
+    void* m_address{nullptr};
+    std::size_t m_size{0};
+    View m_view;
+};
+
+}
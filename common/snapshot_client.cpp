@@ -0,0 +1,104 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "snapshot_client.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+#include <QDBusUnixFileDescriptor>
+
+#include <algorithm>
+
+static QString const s_service = QStringLiteral("org.kde.kded6");
+static QString const s_path = QStringLiteral("/modules/kdisplay");
+static QString const s_interface = QStringLiteral("org.kwinft.kdisplay");
+
+SnapshotClient::SnapshotClient(QObject* parent)
+    : QObject(parent)
+{
+    QDBusConnection::sessionBus().connect(s_service,
+                                          s_path,
+                                          s_interface,
+                                          QStringLiteral("snapshotChanged"),
+                                          this,
+                                          SLOT(onSnapshotChanged(qulonglong)));
+
+    auto watcher = new QDBusServiceWatcher(s_service,
+                                           QDBusConnection::sessionBus(),
+                                           QDBusServiceWatcher::WatchForOwnerChange,
+                                           this);
+    connect(watcher, &QDBusServiceWatcher::serviceOwnerChanged, this, &SnapshotClient::reset);
+}
+
+void SnapshotClient::get(Callback callback)
+{
+    auto const& view = m_mapping.view();
+    if (view.isValid() && view.generation() >= m_latestGeneration) {
+        callback(view);
+        return;
+    }
+
+    m_callbacks.push_back(std::move(callback));
+    fetch();
+}
+
+Snapshot::View const& SnapshotClient::view() const
+{
+    return m_mapping.view();
+}
+
+void SnapshotClient::onSnapshotChanged(qulonglong generation)
+{
+    m_latestGeneration = std::max<uint64_t>(m_latestGeneration, generation);
+}
+
+void SnapshotClient::reset()
+{
+    m_mapping = Snapshot::Mapping();
+    m_latestGeneration = 0;
+}
+
+void SnapshotClient::fetch()
+{
+    if (m_fetching) {
+        return;
+    }
+    m_fetching = true;
+
+    auto const message = QDBusMessage::createMethodCall(
+        s_service, s_path, s_interface, QStringLiteral("getSnapshot"));
+    auto watcher
+        = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher,
+            &QDBusPendingCallWatcher::finished,
+            this,
+            [this](QDBusPendingCallWatcher* watcher) {
+                watcher->deleteLater();
+                m_fetching = false;
+
+                QDBusPendingReply<QDBusUnixFileDescriptor> reply = *watcher;
+                if (reply.isError()) {
+                    m_mapping = Snapshot::Mapping();
+                } else {
+                    // The mapping stays valid after the descriptor is closed.
+                    m_mapping = Snapshot::Mapping(reply.value().fileDescriptor());
+                    m_latestGeneration
+                        = std::max(m_latestGeneration, m_mapping.view().generation());
+                }
+                flush();
+            });
+}
+
+void SnapshotClient::flush()
+{
+    auto const callbacks = std::move(m_callbacks);
+    m_callbacks.clear();
+    for (auto const& callback : callbacks) {
+        callback(m_mapping.view());
+    }
+}
@@ -0,0 +1,48 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "snapshot.h"
+
+#include <QObject>
+
+#include <functional>
+#include <vector>
+
+/**
+ * Maps the config snapshot the daemon publishes and keeps it until the daemon announces a new
+ * generation. Only then is it fetched again, on the next access. A restarted daemon counts its
+ * generations from the start, so the snapshot is dropped when the daemon goes away or comes back.
+ */
+class SnapshotClient : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SnapshotClient(QObject* parent = nullptr);
+
+    using Callback = std::function<void(Snapshot::View const& view)>;
+
+    /**
+     * Calls @p callback with the latest snapshot, right away when it is mapped already. The view
+     * is invalid when the daemon could not be reached and is only valid during the call.
+     */
+    void get(Callback callback);
+
+    Snapshot::View const& view() const;
+
+private Q_SLOTS:
+    void onSnapshotChanged(qulonglong generation);
+
+private:
+    void reset();
+    void fetch();
+    void flush();
+
+    Snapshot::Mapping m_mapping;
+    uint64_t m_latestGeneration{0};
+    bool m_fetching{false};
+    std::vector<Callback> m_callbacks;
+};
@@ -0,0 +1,55 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "startup_timing.h"
+
+#include "trace.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace StartupTiming
+{
+
+static constexpr char const* variable = "KDISPLAY_STARTUP_TIMING";
+
+static int64_t readStart()
+{
+    auto const value = std::getenv(variable);
+    if (!value || !*value) {
+        return 0;
+    }
+    // Set by hand to time the plugin in another host, relative to when it was loaded.
+    return std::string_view(value) == "1" ? Trace::detail::now() : std::strtoll(value, nullptr, 10);
+}
+
+static std::atomic<int64_t> start{readStart()};
+
+void enable()
+{
+    auto const now = Trace::detail::now();
+    start = now;
+    setenv(variable, std::to_string(now).c_str(), 1);
+}
+
+bool enabled()
+{
+    return start != 0;
+}
+
+void mark(char const* phase)
+{
+    Trace::instant("startup", phase);
+    if (!enabled()) {
+        return;
+    }
+    auto const elapsed = Trace::detail::now() - start;
+    std::fprintf(stderr, "kdisplay startup: %8.1f ms  %s\n", elapsed / 1000., phase);
+}
+
+}
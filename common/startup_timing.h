@@ -0,0 +1,27 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+/**
+ * Prints when the phases of starting the kdisplay app and its KCM are reached, to stderr.
+ *
+ * Enabled with `kdisplay --timings`, which passes its start time to the KCM plugin in
+ * KDISPLAY_STARTUP_TIMING, so that all times are relative to the start of the app. Setting it to
+ * 1 times the plugin in other hosts from when it is loaded. Phase names
+ * must be string literals, they also go to the trace.
+ */
+namespace StartupTiming
+{
+
+/**
+ * Starts the clock. Called by the app before anything else.
+ */
+void enable();
+bool enabled();
+
+void mark(char const* phase);
+
+}
@@ -0,0 +1,127 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Trace::detail
+{
+
+static constexpr int buffer_size = 512;
+
+static bool is_enabled()
+{
+    auto const path = std::getenv("KDISPLAY_TRACE");
+    return path && *path;
+}
+
+bool const enabled = is_enabled();
+
+static int open_file()
+{
+    auto const path = std::getenv("KDISPLAY_TRACE");
+    auto const fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::fprintf(stderr, "kdisplay: cannot open trace file %s\n", path);
+        return fd;
+    }
+
+    // Several processes append to the same file. The closing bracket is optional in the trace
+    // event format, so only the first one writes the opening bracket.
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size == 0) {
+        [[maybe_unused]] auto ret = ::write(fd, "[\n", 2);
+    }
+
+    char buffer[256];
+    auto const size = std::snprintf(buffer,
+                                    sizeof(buffer),
+                                    "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                                    "\"args\":{\"name\":\"%s\"}},\n",
+                                    ::getpid(),
+                                    program_invocation_short_name);
+    if (size > 0 && size < static_cast<int>(sizeof(buffer))) {
+        [[maybe_unused]] auto ret = ::write(fd, buffer, size);
+    }
+    return fd;
+}
+
+static void write_event(char const* buffer, int size)
+{
+    static int const fd = open_file();
+
+    // Truncated events would break the file, drop them instead.
+    if (fd < 0 || size <= 0 || size >= buffer_size) {
+        return;
+    }
+
+    // Each event goes out with a single append, so events of different threads and processes
+    // don't interleave.
+    [[maybe_unused]] auto ret = ::write(fd, buffer, size);
+}
+
+int64_t now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void complete(char const* category, char const* name, int64_t start)
+{
+    char buffer[buffer_size];
+    auto const size = std::snprintf(buffer,
+                                    sizeof(buffer),
+                                    "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,"
+                                    "\"dur\":%lld,\"pid\":%d,\"tid\":%d},\n",
+                                    name,
+                                    category,
+                                    static_cast<long long>(start),
+                                    static_cast<long long>(now() - start),
+                                    ::getpid(),
+                                    ::gettid());
+    write_event(buffer, size);
+}
+
+void instant(char const* category, char const* name)
+{
+    char buffer[buffer_size];
+    auto const size = std::snprintf(buffer,
+                                    sizeof(buffer),
+                                    "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\","
+                                    "\"ts\":%lld,\"pid\":%d,\"tid\":%d},\n",
+                                    name,
+                                    category,
+                                    static_cast<long long>(now()),
+                                    ::getpid(),
+                                    ::gettid());
+    write_event(buffer, size);
+}
+
+void async(char phase, char const* category, char const* name, uint64_t id)
+{
+    char buffer[buffer_size];
+    auto const size = std::snprintf(buffer,
+                                    sizeof(buffer),
+                                    "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\","
+                                    "\"id\":\"0x%llx\",\"ts\":%lld,\"pid\":%d,\"tid\":%d},\n",
+                                    name,
+                                    category,
+                                    phase,
+                                    static_cast<unsigned long long>(id),
+                                    static_cast<long long>(now()),
+                                    ::getpid(),
+                                    ::gettid());
+    write_event(buffer, size);
+}
+
+}
@@ -0,0 +1,89 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Opt-in event tracing in the Chrome trace event format.
+ *
+ * Set KDISPLAY_TRACE to a file path to enable it. All processes append to that file, so daemon,
+ * OSD and KCM end up on one timeline that can be loaded into chrome://tracing or Perfetto. When
+ * the variable is not set every call returns after checking a single flag.
+ *
+ * Names and categories must be string literals, they are not escaped.
+ */
+namespace Trace
+{
+
+namespace detail
+{
+extern bool const enabled;
+
+int64_t now();
+void complete(char const* category, char const* name, int64_t start);
+void instant(char const* category, char const* name);
+void async(char phase, char const* category, char const* name, uint64_t id);
+}
+
+inline bool enabled()
+{
+    return detail::enabled;
+}
+
+/**
+ * Records the time between its construction and destruction.
+ */
+class Span
+{
+public:
+    Span(char const* category, char const* name)
+        : m_category(category)
+        , m_name(name)
+        , m_start(enabled() ? detail::now() : 0)
+    {
+    }
+    ~Span()
+    {
+        if (enabled()) {
+            detail::complete(m_category, m_name, m_start);
+        }
+    }
+
+    Span(Span const&) = delete;
+    Span& operator=(Span const&) = delete;
+
+private:
+    char const* m_category;
+    char const* m_name;
+    int64_t m_start;
+};
+
+inline void instant(char const* category, char const* name)
+{
+    if (enabled()) {
+        detail::instant(category, name);
+    }
+}
+
+/**
+ * Spans across event loop iterations. Begin and end are matched by category, name and id.
+ */
+inline void asyncBegin(char const* category, char const* name, uint64_t id)
+{
+    if (enabled()) {
+        detail::async('b', category, name, id);
+    }
+}
+
+inline void asyncEnd(char const* category, char const* name, uint64_t id)
+{
+    if (enabled()) {
+        detail::async('e', category, name, id);
+    }
+}
+
+}
@@ -21,6 +21,7 @@
 
 #include "utils.h"
 
+#include <disman/config.h>
 #include <disman/output.h>
 
 #include <KLocalizedString>
@@ -42,3 +43,33 @@ QString Utils::sizeToString(const QSize& size)
 {
     return QStringLiteral("%1x%2").arg(size.width()).arg(size.height());
 }
+
+Disman::OutputPtr Utils::osdOutput(const Disman::ConfigPtr& config)
+{
+    // Show selector on at most one of the enabled screens
+    auto const outputs = config->outputs();
+    auto primary_output = config->primary_output();
+    for (auto const& [id, output] : outputs) {
+        if (!output->enabled() || !output->commanded_mode()) {
+            continue;
+        }
+
+        // Prefer laptop screen
+        if (output->type() == Disman::Output::Panel) {
+            return output;
+        }
+
+        // Fallback to primary
+        if (output == primary_output) {
+            return output;
+        }
+    }
+
+    // no laptop or primary screen, just take the first usable one
+    for (auto const& [id, output] : outputs) {
+        if (output->enabled() && output->commanded_mode()) {
+            return output;
+        }
+    }
+    return nullptr;
+}
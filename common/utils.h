@@ -34,6 +34,12 @@ QString outputName(const Disman::Output* output);
 QString outputName(const Disman::OutputPtr& output);
 
 QString sizeToString(const QSize& size);
+
+/**
+ * The output the layout selector OSD should be shown on. Prefers the laptop panel, then the
+ * primary output, then the first enabled one. Returns null when no output is usable.
+ */
+Disman::OutputPtr osdOutput(const Disman::ConfigPtr& config);
 }
 
 #endif
@@ -5,9 +5,12 @@
  * SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
  */
 
+#include "../../common/startup_timing.h"
+
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QStyle>
+#include <QTimer>
 
 #include <KAboutData>
 #include <KCMultiDialog>
@@ -15,7 +18,16 @@
 
 int main(int argc, char** argv)
 {
+    // Checked before the application exists so that its construction is timed too.
+    for (int i = 1; i < argc; i++) {
+        if (qstrcmp(argv[i], "--timings") == 0) {
+            StartupTiming::enable();
+        }
+    }
+
     QApplication app(argc, argv);
+    StartupTiming::mark("application");
+
     KAboutData about(QStringLiteral("kdisplay"),
                      i18n("KDisplay"),
                      QStringLiteral(KDISPLAY_VERSION),
@@ -29,6 +41,8 @@ int main(int argc, char** argv)
     QCommandLineParser parser;
     parser.addOption(QCommandLineOption(
         QStringLiteral("args"), i18n("Arguments for the config module."), QStringLiteral("args")));
+    parser.addOption(QCommandLineOption(QStringLiteral("timings"),
+                                        i18n("Print how long the phases of the startup take.")));
 
     about.setupCommandLine(&parser);
     parser.process(app);
@@ -37,6 +51,7 @@ int main(int argc, char** argv)
     auto dialog = new KCMultiDialog;
     dialog->addModule(KPluginMetaData(QStringLiteral("plasma/kcms/systemsettings/kcm_kdisplay")),
                       {parser.value(QStringLiteral("args"))});
+    StartupTiming::mark("moduleAdded");
 
     auto style = dialog->style();
     dialog->setContentsMargins(style->pixelMetric(QStyle::PM_LayoutLeftMargin),
@@ -46,6 +61,12 @@ int main(int argc, char** argv)
 
     dialog->setAttribute(Qt::WA_DeleteOnClose);
     dialog->show();
+    StartupTiming::mark("dialogShown");
+
+    if (StartupTiming::enabled()) {
+        // Runs on the first event loop iteration, after the work queued during startup.
+        QTimer::singleShot(0, &app, [] { StartupTiming::mark("eventLoopIdle"); });
+    }
 
     app.setQuitOnLastWindowClosed(true);
 
@@ -0,0 +1,81 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "config_cache.h"
+
+#include "../common/fingerprint.h"
+#include "../common/snapshot.h"
+#include "../common/trace.h"
+#include "kcm_kdisplay_debug.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace ConfigCache
+{
+
+QString path()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+        + QStringLiteral("/kdisplay/kcm.snapshot");
+}
+
+static uint64_t cachedFingerprint(QFile& file)
+{
+    Snapshot::Header header;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)
+        || header.version != Snapshot::version) {
+        return 0;
+    }
+    return header.fingerprint;
+}
+
+Disman::ConfigPtr load()
+{
+    Trace::Span span("kcm", "ConfigCache::load");
+
+    QFile file(path());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    // Read rather than mapped, the file can be replaced or truncated while the KCM starts.
+    auto const data = file.readAll();
+    Snapshot::View const view(data.constData(), data.size());
+    if (!view.isValid()) {
+        qCDebug(KDISPLAY_KCM) << "Ignoring invalid config cache" << file.fileName();
+        return nullptr;
+    }
+    return Snapshot::toConfig(view);
+}
+
+void store(Disman::ConfigPtr const& config)
+{
+    Trace::Span span("kcm", "ConfigCache::store");
+
+    auto const fingerprint = Fingerprint::config(config);
+    if (!fingerprint) {
+        return;
+    }
+
+    QFile current(path());
+    if (current.open(QIODevice::ReadOnly) && cachedFingerprint(current) == fingerprint) {
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(path()).absolutePath());
+    QSaveFile file(path());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(KDISPLAY_KCM) << "Failed to write config cache:" << file.errorString();
+        return;
+    }
+    file.write(Snapshot::serialize(config, 0));
+    file.commit();
+}
+
+}
@@ -0,0 +1,31 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <disman/types.h>
+
+#include <QString>
+
+/**
+ * The last config the KCM saw, kept as a snapshot in the cache directory so that the next start
+ * can show the layout before the backend replies.
+ */
+namespace ConfigCache
+{
+
+QString path();
+
+/**
+ * A config for display only or null when there is no usable cache.
+ */
+Disman::ConfigPtr load();
+
+/**
+ * Replaces the cache with @p config unless the cached snapshot has the same fingerprint.
+ */
+void store(Disman::ConfigPtr const& config);
+
+}
@@ -16,6 +16,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 *********************************************************************/
 #include "config_handler.h"
 
+#include "../common/fingerprint.h"
+#include "../common/trace.h"
 #include "kcm_kdisplay_debug.h"
 #include "output_model.h"
 
@@ -24,6 +26,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QRect>
 
+#include <utility>
+
 using namespace Disman;
 
 ConfigHandler::ConfigHandler(QObject* parent)
@@ -33,24 +37,21 @@ ConfigHandler::ConfigHandler(QObject* parent)
 
 void ConfigHandler::setConfig(Disman::ConfigPtr config)
 {
+    auto const wasPreview = std::exchange(m_preview, false);
+
     m_config = config;
     m_initialConfig = m_config->clone();
+    updateInitialFingerprints();
     Disman::ConfigMonitor::instance()->add_config(m_config);
 
-    m_outputs = new OutputModel(this);
-    connect(
-        m_outputs, &OutputModel::positionChanged, this, &ConfigHandler::checkScreenNormalization);
-    connect(m_outputs, &OutputModel::sizeChanged, this, &ConfigHandler::checkScreenNormalization);
-
-    for (auto const& [key, output] : config->outputs()) {
-        initOutput(output);
+    auto const reconciled = wasPreview && m_outputs && m_outputs->replaceConfig(m_config);
+    if (reconciled) {
+        qCDebug(KDISPLAY_KCM) << "Reconciled the preview with the fetched config";
+        m_lastNormalizedScreenSize = screenSize();
+    } else {
+        replaceModel();
     }
-    m_lastNormalizedScreenSize = screenSize();
 
-    connect(m_outputs, &OutputModel::changed, this, [this]() {
-        checkNeedsSave();
-        Q_EMIT changed();
-    });
     connect(m_config.get(), &Disman::Config::output_added, this, [this]() {
         Q_EMIT outputConnect(true);
     });
@@ -62,9 +63,45 @@ void ConfigHandler::setConfig(Disman::ConfigPtr config)
             this,
             &ConfigHandler::primaryOutputChanged);
 
+    if (!reconciled) {
+        Q_EMIT outputModelChanged();
+    }
+}
+
+void ConfigHandler::setPreview(Disman::ConfigPtr config)
+{
+    m_preview = true;
+    m_config = config;
+    m_initialConfig = config;
+    updateInitialFingerprints();
+
+    replaceModel();
     Q_EMIT outputModelChanged();
 }
 
+void ConfigHandler::replaceModel()
+{
+    // QML may still hold the previous model until it learns about the new one.
+    if (m_outputs) {
+        m_outputs->deleteLater();
+    }
+
+    m_outputs = new OutputModel(this);
+    connect(
+        m_outputs, &OutputModel::positionChanged, this, &ConfigHandler::checkScreenNormalization);
+    connect(m_outputs, &OutputModel::sizeChanged, this, &ConfigHandler::checkScreenNormalization);
+
+    for (auto const& [key, output] : m_config->outputs()) {
+        initOutput(output);
+    }
+    m_lastNormalizedScreenSize = screenSize();
+
+    connect(m_outputs, &OutputModel::changed, this, [this]() {
+        checkNeedsSave();
+        Q_EMIT changed();
+    });
+}
+
 void ConfigHandler::initOutput(const Disman::OutputPtr& output)
 {
     m_outputs->add(output);
@@ -78,12 +115,14 @@ void ConfigHandler::updateInitialData()
                 return;
             }
             m_initialConfig = qobject_cast<GetConfigOperation*>(op)->config();
+            updateInitialFingerprints();
             checkNeedsSave();
         });
 }
 
 void ConfigHandler::checkNeedsSave()
 {
+    Trace::Span span("kcm", "ConfigHandler::checkNeedsSave");
     if (m_config->supported_features() & Disman::Config::Feature::PrimaryDisplay) {
         if (m_config->primary_output() && m_initialConfig->primary_output()) {
             if (m_config->primary_output()->hash() != m_initialConfig->primary_output()->hash()) {
@@ -97,39 +136,26 @@ void ConfigHandler::checkNeedsSave()
     }
 
     for (auto const& [key, output] : m_config->outputs()) {
-        auto const hash = output->hash();
-        for (auto const& [initial_key, initialOutput] : m_initialConfig->outputs()) {
-            if (hash != initialOutput->hash()) {
-                continue;
-            }
-            bool needsSave = false;
-            if (output->enabled() != initialOutput->enabled()) {
-                needsSave = true;
-            }
-            if (output->enabled()) {
-                needsSave |= output->auto_mode()->id() != initialOutput->auto_mode()->id()
-                    || output->position() != initialOutput->position()
-                    || output->scale() != initialOutput->scale()
-                    || output->rotation() != initialOutput->rotation()
-                    || output->adaptive_sync() != initialOutput->adaptive_sync()
-                    || output->replication_source() != initialOutput->replication_source()
-                    || output->retention() != initialOutput->retention()
-                    || output->auto_resolution() != initialOutput->auto_resolution()
-                    || output->auto_refresh_rate() != initialOutput->auto_refresh_rate()
-                    || output->auto_rotate() != initialOutput->auto_rotate()
-                    || output->auto_rotate_only_in_tablet_mode()
-                        != initialOutput->auto_rotate_only_in_tablet_mode();
-            }
-            if (needsSave) {
-                Q_EMIT needsSaveChecked(true);
-                return;
-            }
-            break;
+        auto const initial = m_initialFingerprints.find(output->hash());
+        if (initial == m_initialFingerprints.end()) {
+            continue;
+        }
+        if (Fingerprint::output(output) != initial->second) {
+            Q_EMIT needsSaveChecked(true);
+            return;
         }
     }
     Q_EMIT needsSaveChecked(false);
 }
 
+void ConfigHandler::updateInitialFingerprints()
+{
+    m_initialFingerprints.clear();
+    for (auto const& [key, output] : m_initialConfig->outputs()) {
+        m_initialFingerprints.try_emplace(output->hash(), Fingerprint::output(output));
+    }
+}
+
 QSize ConfigHandler::screenSize() const
 {
     int width = 0, height = 0;
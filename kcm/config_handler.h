@@ -19,7 +19,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <disman/config.h>
 #include <disman/output.h>
 
+#include <map>
 #include <memory>
+#include <string>
 
 class OutputModel;
 
@@ -31,6 +33,15 @@ public:
     ~ConfigHandler() override = default;
 
     void setConfig(Disman::ConfigPtr config);
+    /**
+     * Shows @p config, for example from the cache, until setConfig is called. The model is
+     * kept on setConfig when the outputs are the same, so only the rows that differ change.
+     */
+    void setPreview(Disman::ConfigPtr config);
+    bool isPreview() const
+    {
+        return m_preview;
+    }
     void updateInitialData();
 
     OutputModel* outputModel() const
@@ -70,10 +81,15 @@ private:
     void primaryOutputSelected(int index);
     void primaryOutputChanged(const Disman::OutputPtr& output);
     void initOutput(const Disman::OutputPtr& output);
+    void replaceModel();
+    void updateInitialFingerprints();
 
     Disman::ConfigPtr m_config = nullptr;
     Disman::ConfigPtr m_initialConfig;
+    // Fingerprints of the initial outputs by their hash.
+    std::map<std::string, uint64_t> m_initialFingerprints;
     OutputModel* m_outputs = nullptr;
+    bool m_preview = false;
 
     QSize m_lastNormalizedScreenSize;
 };
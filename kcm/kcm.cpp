@@ -17,6 +17,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "kcm.h"
 
 #include "../common/orientation_sensor.h"
+#include "../common/startup_timing.h"
+#include "../common/trace.h"
+#include "config_cache.h"
 #include "config_handler.h"
 #include "kcm_kdisplay_debug.h"
 #include "output_identifier.h"
@@ -27,14 +30,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <disman/output.h>
 #include <disman/setconfigoperation.h>
 
+#include <KConfig>
 #include <KConfigGroup>
 #include <KLocalizedString>
 #include <KPluginFactory>
 #include <KSharedConfig>
 
+#include <QCoreApplication>
 #include <QProcess>
 #include <QTimer>
 
+#include <utility>
+
 K_PLUGIN_CLASS_WITH_JSON(KCMKDisplay, "kcm_kdisplay.json")
 
 using namespace Disman;
@@ -42,9 +49,6 @@ using namespace Disman;
 KCMKDisplay::KCMKDisplay(QObject* parent, KPluginMetaData const& data)
     : KQuickManagedConfigModule(parent, data)
 {
-    qmlRegisterAnonymousType<OutputModel>("org.kwinft.private.kcm.screen", 1);
-    qmlRegisterType<Disman::Output>("org.kwinft.private.kcm.kdisplay", 1, 0, "Output");
-
     Log::instance();
 
     setButtons(Apply);
@@ -59,24 +63,89 @@ KCMKDisplay::KCMKDisplay(QObject* parent, KPluginMetaData const& data)
             &OrientationSensor::availableChanged,
             this,
             &KCMKDisplay::orientationSensorAvailableChanged);
+
+    prefetch();
+    StartupTiming::mark("kcmConstructed");
+}
+
+static qreal readGlobalScale()
+{
+    // Not the shared config since this may run on another thread.
+    KConfig const config(QStringLiteral("kdeglobals"));
+    return config.group(QStringLiteral("KScreen")).readEntry("ScaleFactor", 1.0);
+}
+
+void KCMKDisplay::prefetch()
+{
+    Trace::Span span("kcm", "KCMKDisplay::prefetch");
+
+    // The config comes from the backend and the global scale from disk. Both are started first
+    // so they overlap with the sensor probe here and the QML setup after the constructor.
+    m_prefetching = true;
+    connect(new GetConfigOperation(),
+            &GetConfigOperation::finished,
+            this,
+            [this](ConfigOperation* op) {
+                StartupTiming::mark("configFetched");
+                m_prefetching = false;
+
+                auto config = op->has_error() ? nullptr
+                                              : qobject_cast<GetConfigOperation*>(op)->config();
+                if (std::exchange(m_awaitingPrefetch, false)) {
+                    configReady(config);
+                } else {
+                    m_prefetchedConfig = config;
+                }
+            });
+
+    m_prefetchedGlobalScale = std::async(std::launch::async, [] {
+        auto const scale = readGlobalScale();
+        StartupTiming::mark("globalScaleRead");
+        return scale;
+    });
+
+    // Sensor backends are bound to the thread they are created on, so the probe runs here.
+    m_orientationSensor->available();
+    StartupTiming::mark("sensorProbed");
+}
+
+void KCMKDisplay::fetchConfig()
+{
+    if (m_prefetchedConfig) {
+        auto const config = *std::exchange(m_prefetchedConfig, std::nullopt);
+        configReady(config);
+        return;
+    }
+    if (m_prefetching) {
+        m_awaitingPrefetch = true;
+        return;
+    }
+
+    connect(new GetConfigOperation(),
+            &GetConfigOperation::finished,
+            this,
+            [this](ConfigOperation* op) {
+                configReady(op->has_error() ? nullptr
+                                            : qobject_cast<GetConfigOperation*>(op)->config());
+            });
 }
 
-void KCMKDisplay::configReady(ConfigOperation* op)
+void KCMKDisplay::configReady(Disman::ConfigPtr const& config)
 {
     qCDebug(KDISPLAY_KCM) << "Reading in config now.";
-    if (op->has_error()) {
+    if (!config) {
         m_config.reset();
         Q_EMIT backendError();
         return;
     }
-
-    Disman::ConfigPtr config = qobject_cast<GetConfigOperation*>(op)->config();
     const bool autoRotationSupported = config->supported_features()
         & (Disman::Config::Feature::AutoRotation | Disman::Config::Feature::TabletMode);
     m_orientationSensor->setEnabled(autoRotationSupported);
 
     m_config->setConfig(config);
     setBackendReady(true);
+    StartupTiming::mark("configShown");
+    ConfigCache::store(config);
     Q_EMIT perOutputScalingChanged();
     Q_EMIT supports_adaptive_sync_changed();
     Q_EMIT primaryOutputSupportedChanged();
@@ -88,6 +157,7 @@ void KCMKDisplay::configReady(ConfigOperation* op)
 
 void KCMKDisplay::save()
 {
+    Trace::Span span("kcm", "KCMKDisplay::save");
     if (!m_config) {
         Q_EMIT errorOnSave();
         return;
@@ -145,7 +215,9 @@ void KCMKDisplay::save()
     // completed, otherwise ConfigModule might terminate before we get to
     // execute the Operation.
     auto* op = new SetConfigOperation(config);
-    op->exec();
+    if (op->exec()) {
+        ConfigCache::store(config);
+    }
 
     // The 1000ms is a legacy value tested to work for randr having
     // enough time to change configuration.
@@ -182,13 +254,14 @@ OutputModel* KCMKDisplay::outputModel() const
 
 void KCMKDisplay::identifyOutputs()
 {
-    if (!m_config || !m_config->initialConfig() || m_outputIdentifier) {
+    if (!m_config || !m_config->initialConfig()) {
         return;
     }
-    m_outputIdentifier.reset(new OutputIdentifier(m_config->initialConfig(), this));
-    connect(m_outputIdentifier.get(), &OutputIdentifier::identifiersFinished, this, [this]() {
-        m_outputIdentifier.reset();
-    });
+    if (!m_outputIdentifier) {
+        // Its engine and QML are only needed once identifying is used.
+        m_outputIdentifier = std::make_unique<OutputIdentifier>();
+    }
+    m_outputIdentifier->identify(m_config->initialConfig());
 }
 
 QSize KCMKDisplay::normalizeScreen() const
@@ -276,6 +349,7 @@ void KCMKDisplay::defaults()
 void KCMKDisplay::load()
 {
     qCDebug(KDISPLAY_KCM) << "About to read in config.";
+    StartupTiming::mark("load");
 
     setBackendReady(false);
     setNeedsSave(false);
@@ -289,6 +363,7 @@ void KCMKDisplay::load()
     // We take the m_config pointer so outputModel() will return null,
     // gracefully cleaning up the QML side and only then we will delete it.
     auto* oldConfig = m_config.release();
+    auto const firstLoad = !oldConfig;
     if (oldConfig) {
         Q_EMIT outputModelChanged();
         delete oldConfig;
@@ -325,8 +400,16 @@ void KCMKDisplay::load()
 
     connect(m_config.get(), &ConfigHandler::changed, this, &KCMKDisplay::changed);
 
-    connect(
-        new GetConfigOperation(), &GetConfigOperation::finished, this, &KCMKDisplay::configReady);
+    // Show the last known layout read-only until the backend replies. Not on reloads, which
+    // mostly follow a change the cache does not know about yet.
+    if (firstLoad) {
+        if (auto cached = ConfigCache::load()) {
+            m_config->setPreview(cached);
+            StartupTiming::mark("previewShown");
+        }
+    }
+
+    fetchConfig();
 
     Q_EMIT changed();
 }
@@ -342,8 +425,9 @@ void KCMKDisplay::continueNeedsSaveCheck(bool needs)
 
 void KCMKDisplay::fetchGlobalScale()
 {
-    const auto config = KSharedConfig::openConfig(QStringLiteral("kdeglobals"));
-    const qreal scale = config->group("KScreen").readEntry("ScaleFactor", 1.0);
+    // Only the first load can take the prefetched value, later ones may follow a save.
+    const qreal scale = m_prefetchedGlobalScale.valid() ? m_prefetchedGlobalScale.get()
+                                                        : readGlobalScale();
     m_initialGlobalScale = scale;
     setGlobalScale(scale);
 }
@@ -353,8 +437,6 @@ void KCMKDisplay::writeGlobalScale()
     if (qFuzzyCompare(m_initialGlobalScale, m_globalScale)) {
         return;
     }
-    auto config = KSharedConfig::openConfig(QStringLiteral("kdeglobals"));
-    config->group("KScreen").writeEntry("ScaleFactor", m_globalScale);
 
     // Write env var to be used by session startup scripts to populate the QT_SCREEN_SCALE_FACTORS
     // env var.
@@ -367,57 +449,94 @@ void KCMKDisplay::writeGlobalScale()
         screenFactors.append(QString::fromStdString(output->name()) + QLatin1Char('=')
                              + QString::number(m_globalScale) + QLatin1Char(';'));
     }
-    config->group("KScreen").writeEntry("ScreenScaleFactors", screenFactors);
+
+    // If dpi is the default (96) remove the entry rather than setting it.
+    auto const scaleDpi = qFuzzyCompare(m_globalScale, 1.0) ? 0 : qRound(m_globalScale * 96.0);
+
+    auto config = KSharedConfig::openConfig(QStringLiteral("kdeglobals"));
+    auto screenGroup = config->group("KScreen");
+    screenGroup.writeEntry("ScaleFactor", m_globalScale);
+    screenGroup.writeEntry("ScreenScaleFactors", screenFactors);
 
     KConfig fontConfig(QStringLiteral("kcmfonts"));
-    auto fontConfigGroup = fontConfig.group("General");
-
-    if (qFuzzyCompare(m_globalScale, 1.0)) {
-        // if dpi is the default (96) remove the entry rather than setting it
-        QProcess queryProc;
-        queryProc.start(QStringLiteral("xrdb"), {QStringLiteral("-query")});
-        if (queryProc.waitForFinished()) {
-            QByteArray db = queryProc.readAllStandardOutput();
-            int idx1 = 0;
-            while (idx1 < db.size()) {
-                int idx2 = db.indexOf('\n', idx1);
-                if (idx2 == -1) {
-                    idx2 = db.size() - 1;
-                }
-                const auto entry = QByteArray::fromRawData(db.constData() + idx1, idx2 - idx1 + 1);
-                if (entry.startsWith("Xft.dpi:")) {
-                    db.remove(idx1, entry.size());
-                } else {
-                    idx1 = idx2 + 1;
-                }
-            }
-
-            QProcess loadProc;
-            loadProc.start(
-                QStringLiteral("xrdb"),
-                {QStringLiteral("-quiet"), QStringLiteral("-load"), QStringLiteral("-nocpp")});
-            if (loadProc.waitForStarted()) {
-                loadProc.write(db);
-                loadProc.closeWriteChannel();
-                loadProc.waitForFinished();
-            }
+    fontConfig.group("General").writeEntry("forceFontDPI", scaleDpi);
+
+    config->sync();
+    fontConfig.sync();
+
+    writeXftDpi(scaleDpi);
+
+    m_initialGlobalScale = m_globalScale;
+    Q_EMIT globalScaleWritten();
+}
+
+static QByteArray removeXftDpi(QByteArray const& db)
+{
+    QByteArray ret;
+    ret.reserve(db.size());
+
+    qsizetype begin = 0;
+    while (begin < db.size()) {
+        auto end = db.indexOf('\n', begin);
+        end = end < 0 ? db.size() : end + 1;
+
+        auto const entry = QByteArrayView(db.constData() + begin, end - begin);
+        if (!entry.startsWith("Xft.dpi:")) {
+            ret.append(entry);
         }
-        fontConfigGroup.writeEntry("forceFontDPI", 0);
-    } else {
-        const int scaleDpi = qRound(m_globalScale * 96.0);
-        QProcess proc;
-        proc.start(QStringLiteral("xrdb"),
-                   {QStringLiteral("-quiet"), QStringLiteral("-merge"), QStringLiteral("-nocpp")});
-        if (proc.waitForStarted()) {
-            proc.write(QByteArray("Xft.dpi: " + QString::number(scaleDpi).toLatin1()));
-            proc.closeWriteChannel();
-            proc.waitForFinished();
+        begin = end;
+    }
+    return ret;
+}
+
+static QProcess* startXrdb(QStringList const& args)
+{
+    // The process is parented to the application so it outlives the KCM when that is closed
+    // before xrdb returns.
+    auto proc = new QProcess(qApp);
+    QObject::connect(proc, &QProcess::finished, proc, &QObject::deleteLater);
+    QObject::connect(proc, &QProcess::errorOccurred, proc, [proc](auto error) {
+        if (error == QProcess::FailedToStart) {
+            qCWarning(KDISPLAY_KCM) << "Failed to start xrdb:" << proc->errorString();
+            proc->deleteLater();
         }
-        fontConfigGroup.writeEntry("forceFontDPI", scaleDpi);
+    });
+    proc->start(QStringLiteral("xrdb"), args);
+    return proc;
+}
+
+void KCMKDisplay::writeXftDpi(int dpi)
+{
+    if (qEnvironmentVariableIsEmpty("DISPLAY")) {
+        // No X server (not even Xwayland) we could set resources on.
+        return;
     }
 
-    m_initialGlobalScale = m_globalScale;
-    Q_EMIT globalScaleWritten();
+    auto const loadArgs
+        = QStringList{QStringLiteral("-quiet"), QStringLiteral("-load"), QStringLiteral("-nocpp")};
+    auto const mergeArgs
+        = QStringList{QStringLiteral("-quiet"), QStringLiteral("-merge"), QStringLiteral("-nocpp")};
+
+    if (dpi > 0) {
+        auto proc = startXrdb(mergeArgs);
+        proc->write("Xft.dpi: " + QByteArray::number(dpi) + '\n');
+        proc->closeWriteChannel();
+        return;
+    }
+
+    auto query = startXrdb({QStringLiteral("-query")});
+    connect(query,
+            &QProcess::finished,
+            query,
+            [query, loadArgs](int exitCode, QProcess::ExitStatus status) {
+                if (status != QProcess::NormalExit || exitCode != 0) {
+                    qCWarning(KDISPLAY_KCM) << "Querying X resources failed.";
+                    return;
+                }
+                auto load = startXrdb(loadArgs);
+                load->write(removeXftDpi(query->readAllStandardOutput()));
+                load->closeWriteChannel();
+            });
 }
 
 qreal KCMKDisplay::globalScale() const
@@ -20,6 +20,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <KQuickManagedConfigModule>
 
+#include <future>
+#include <optional>
+
 class QTimer;
 
 namespace Disman
@@ -116,10 +119,13 @@ private:
     void setBackendReady(bool error);
     void setScreenNormalized(bool normalized);
 
+    void prefetch();
     void fetchGlobalScale();
     void writeGlobalScale();
+    void writeXftDpi(int dpi);
 
-    void configReady(Disman::ConfigOperation* op);
+    void fetchConfig();
+    void configReady(Disman::ConfigPtr const& config);
     void continueNeedsSaveCheck(bool needs);
 
     std::unique_ptr<OutputIdentifier> m_outputIdentifier;
@@ -131,4 +137,10 @@ private:
     double m_initialGlobalScale = 1.;
 
     QTimer* m_loadCompressor;
+
+    // Started on construction to run while the QML is set up, taken by the first load.
+    bool m_prefetching = false;
+    bool m_awaitingPrefetch = false;
+    std::optional<Disman::ConfigPtr> m_prefetchedConfig;
+    std::future<qreal> m_prefetchedGlobalScale;
 };
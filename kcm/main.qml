@@ -0,0 +1,11 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+import org.kwinft.private.kcm.kdisplay 1.0 as KDisplay
+
+// KCMUtils loads the page from the plugin's /kcm resources. The actual page is part of the
+// ahead-of-time compiled QML module.
+KDisplay.Main {
+}
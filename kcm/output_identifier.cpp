@@ -17,47 +17,109 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "output_identifier.h"
 
 #include "../common/utils.h"
+#include "kcm_kdisplay_debug.h"
 
 #include <disman/output.h>
 
+#include <QQmlComponent>
 #include <QQuickItem>
-#include <QQuickView>
-#include <QStandardPaths>
+#include <QQuickWindow>
 #include <QSurfaceFormat>
 #include <QTimer>
+#include <QtMath>
 
-#define QML_PATH "kpackage/kcms/kcm_kdisplay/contents/ui/"
-
-OutputIdentifier::OutputIdentifier(Disman::ConfigPtr config, QObject* parent)
+OutputIdentifier::OutputIdentifier(QObject* parent)
     : QObject(parent)
+    , m_component(new QQmlComponent(&m_engine, &m_engine))
+    , m_hideTimer(new QTimer(this))
 {
     QQuickWindow::setDefaultAlphaBuffer(true);
-    const QString qmlPath = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
-                                                   QStringLiteral(QML_PATH "OutputIdentifier.qml"));
 
-    for (auto const& [key, output] : config->outputs()) {
-        if (!output->auto_mode()) {
-            continue;
+    m_hideTimer->setInterval(2500);
+    m_hideTimer->setSingleShot(true);
+    connect(m_hideTimer, &QTimer::timeout, this, &OutputIdentifier::hide);
+
+    connect(m_component, &QQmlComponent::statusChanged, this, [this](auto status) {
+        if (status == QQmlComponent::Error) {
+            qCWarning(KDISPLAY_KCM) << "Failed to load output identifier:" << m_component->errorString();
+            m_config.reset();
+            return;
         }
+        if (status == QQmlComponent::Ready && m_config) {
+            show();
+        }
+    });
 
-        auto const mode = output->auto_mode();
+    // Load the component off the GUI thread already now, so it is ready when requested.
+    m_component->loadUrl(
+        QUrl(QStringLiteral("qrc:/qt/qml/org/kwinft/private/kcm/kdisplay/OutputIdentifier.qml")),
+        QQmlComponent::Asynchronous);
+}
+
+OutputIdentifier::~OutputIdentifier() = default;
 
-        auto view = new QQuickView;
-        QSurfaceFormat format;
-        format.setAlphaBufferSize(8);
-        view->setFormat(format);
-        view->setColor(QColor(0, 0, 0, 0));
-        view->setFlags(Qt::X11BypassWindowManagerHint | Qt::FramelessWindowHint);
-        view->setSource(QUrl::fromLocalFile(qmlPath));
+void OutputIdentifier::identify(Disman::ConfigPtr const& config)
+{
+    m_config = config;
+
+    if (m_component->isReady()) {
+        show();
+    }
+}
+
+OutputIdentifier::View* OutputIdentifier::view(size_t index)
+{
+    if (index < m_views.size()) {
+        return m_views.at(index).get();
+    }
+
+    auto object = m_component->create();
+    auto item = qobject_cast<QQuickItem*>(object);
+    if (!item) {
+        delete object;
+        return nullptr;
+    }
 
-        view->installEventFilter(this);
+    auto view = std::make_unique<View>();
+    view->window = std::make_unique<QQuickWindow>();
+    view->item = item;
 
-        auto rootObj = view->rootObject();
-        if (!rootObj) {
-            delete view;
+    QSurfaceFormat format;
+    format.setAlphaBufferSize(8);
+    view->window->setFormat(format);
+    view->window->setColor(QColor(0, 0, 0, 0));
+    view->window->setFlags(Qt::X11BypassWindowManagerHint | Qt::FramelessWindowHint);
+
+    item->setParent(view->window.get());
+    item->setParentItem(view->window->contentItem());
+
+    auto const raw = view.get();
+    connect(item, &QQuickItem::widthChanged, this, [this, raw] { center(*raw); });
+    connect(item, &QQuickItem::heightChanged, this, [this, raw] { center(*raw); });
+
+    m_views.push_back(std::move(view));
+    return raw;
+}
+
+void OutputIdentifier::show()
+{
+    auto const config = m_config;
+    m_config.reset();
+
+    size_t index = 0;
+    for (auto const& [key, output] : config->outputs()) {
+        if (!output->auto_mode()) {
             continue;
         }
 
+        auto view = this->view(index);
+        if (!view) {
+            continue;
+        }
+        index++;
+
+        auto const mode = output->auto_mode();
+
         QSize deviceSize;
         QSizeF logicalSize;
         if (output->horizontal()) {
@@ -69,35 +131,35 @@ OutputIdentifier::OutputIdentifier(Disman::ConfigPtr config, QObject* parent)
             // Scale adjustment is not needed on Wayland, we use logical size.
             logicalSize = output->geometry().size();
         } else {
-            logicalSize = deviceSize / view->effectiveDevicePixelRatio();
+            logicalSize = deviceSize / view->window->effectiveDevicePixelRatio();
         }
-        rootObj->setProperty("outputName", Utils::outputName(output));
-        rootObj->setProperty("modeName", Utils::sizeToString(deviceSize));
-        view->setProperty("screenSize", QRectF(output->position(), logicalSize).toRect());
-        m_views << view;
+        view->item->setProperty("outputName", Utils::outputName(output));
+        view->item->setProperty("modeName", Utils::sizeToString(deviceSize));
+        view->screenRect = QRectF(output->position(), logicalSize).toRect();
+
+        center(*view);
+        view->window->show();
     }
 
-    for (auto* view : m_views) {
-        view->show();
+    // Views of outputs that are gone stay in the pool for later requests.
+    for (; index < m_views.size(); index++) {
+        m_views.at(index)->window->hide();
     }
-    QTimer::singleShot(2500, this, &OutputIdentifier::identifiersFinished);
+
+    m_hideTimer->start();
 }
 
-OutputIdentifier::~OutputIdentifier()
+void OutputIdentifier::center(View& view)
 {
-    qDeleteAll(m_views);
+    QRect geometry(0, 0, qCeil(view.item->width()), qCeil(view.item->height()));
+    geometry.moveCenter(view.screenRect.center());
+    view.window->setGeometry(geometry);
 }
 
-bool OutputIdentifier::eventFilter(QObject* object, QEvent* event)
+void OutputIdentifier::hide()
 {
-    if (event->type() == QEvent::Resize) {
-        if (m_views.contains(qobject_cast<QQuickView*>(object))) {
-            QResizeEvent* e = static_cast<QResizeEvent*>(event);
-            const QRect screenSize = object->property("screenSize").toRect();
-            QRect geometry(QPoint(0, 0), e->size());
-            geometry.moveCenter(screenSize.center());
-            static_cast<QQuickView*>(object)->setGeometry(geometry);
-        }
+    for (auto const& view : m_views) {
+        view->window->hide();
     }
-    return QObject::eventFilter(object, event);
+    Q_EMIT identifiersFinished();
 }
@@ -18,24 +18,49 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <disman/config.h>
 
-#include <QVector>
+#include <QQmlEngine>
+#include <QRect>
 
-class QQuickView;
+#include <memory>
+#include <vector>
 
+class QQmlComponent;
+class QQuickItem;
+class QQuickWindow;
+class QTimer;
+
+/**
+ * Shows the name and resolution of each output on top of it. The QML component is compiled once
+ * on construction and the overlay windows are kept in a pool that is reused on later requests.
+ */
 class OutputIdentifier : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit OutputIdentifier(Disman::ConfigPtr config, QObject* parent = nullptr);
+    explicit OutputIdentifier(QObject* parent = nullptr);
     ~OutputIdentifier() override;
 
+    void identify(Disman::ConfigPtr const& config);
+
 Q_SIGNALS:
     void identifiersFinished();
 
-protected:
-    bool eventFilter(QObject* object, QEvent* event) override;
-
 private:
-    QVector<QQuickView*> m_views;
+    struct View {
+        std::unique_ptr<QQuickWindow> window;
+        QQuickItem* item = nullptr;
+        QRect screenRect;
+    };
+
+    void show();
+    View* view(size_t index);
+    void center(View& view);
+    void hide();
+
+    QQmlEngine m_engine;
+    QQmlComponent* m_component;
+    std::vector<std::unique_ptr<View>> m_views;
+    Disman::ConfigPtr m_config;
+    QTimer* m_hideTimer;
 };
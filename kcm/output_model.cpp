@@ -16,6 +16,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 *********************************************************************/
 #include "output_model.h"
 
+#include "../common/fingerprint.h"
+#include "../common/trace.h"
 #include "../common/utils.h"
 
 #include "config_handler.h"
@@ -24,6 +26,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QRect>
 
+#include <algorithm>
+#include <vector>
+
 OutputModel::OutputModel(ConfigHandler* configHandler)
     : QAbstractListModel(configHandler)
     , m_config(configHandler)
@@ -109,6 +114,7 @@ QVariant OutputModel::data(const QModelIndex& index, int role) const
 
 bool OutputModel::setData(const QModelIndex& index, const QVariant& value, int role)
 {
+    Trace::Span span("kcm", "OutputModel::setData");
     if (index.row() < 0 || index.row() >= m_outputs.count()) {
         return false;
     }
@@ -289,6 +295,59 @@ void OutputModel::remove(int outputId)
     }
 }
 
+bool OutputModel::replaceConfig(const Disman::ConfigPtr& config)
+{
+    Trace::Span span("kcm", "OutputModel::replaceConfig");
+
+    auto const outputs = config->outputs();
+    if (outputs.size() != static_cast<std::size_t>(m_outputs.size())) {
+        return false;
+    }
+    for (auto const& row : std::as_const(m_outputs)) {
+        auto const it = outputs.find(row.ptr->id());
+        if (it == outputs.end() || it->second->hash() != row.ptr->hash()) {
+            return false;
+        }
+    }
+
+    // Keep the view where it is.
+    auto const delta = m_outputs.isEmpty() ? QPointF()
+                                           : m_outputs[0].pos - m_outputs[0].ptr->position();
+
+    std::vector<int> changedIds;
+    for (auto& row : m_outputs) {
+        auto const& output = outputs.at(row.ptr->id());
+        if (Fingerprint::output(output) != Fingerprint::output(row.ptr)) {
+            changedIds.push_back(output->id());
+        }
+        row.ptr = output;
+        row.pos = output->position() + delta;
+        row.posReset = QPointF(-1, -1);
+
+        connect(config.get(), &Disman::Config::primary_output_changed, this, [this, output] {
+            roleChanged(output->id(), PrimaryRole);
+        });
+    }
+    updateOrder();
+
+    // The previous outputs may have come with fewer modes or without some capabilities, so what
+    // is derived from those is announced for every row.
+    QVector<int> const derivedRoles{PrimaryRole,
+                                    ResolutionIndexRole,
+                                    ResolutionsRole,
+                                    RefreshRateIndexRole,
+                                    RefreshRatesRole,
+                                    AdaptiveSyncToggleSupportRole};
+    for (int i = 0; i < m_outputs.size(); i++) {
+        auto const index = createIndex(i, 0);
+        auto const id = m_outputs[i].ptr->id();
+        auto const changed
+            = std::find(changedIds.cbegin(), changedIds.cend(), id) != changedIds.cend();
+        Q_EMIT dataChanged(index, index, changed ? QVector<int>() : derivedRoles);
+    }
+    return true;
+}
+
 void OutputModel::resetPosition(const Output& output)
 {
     if (output.posReset.x() < 0) {
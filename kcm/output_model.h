@@ -21,12 +21,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QAbstractListModel>
 #include <QPoint>
+#include <QQmlEngine>
 
 class ConfigHandler;
 
 class OutputModel : public QAbstractListModel
 {
     Q_OBJECT
+    QML_ANONYMOUS
+
 public:
     enum OutputRoles {
         EnabledRole = Qt::UserRole + 1,
@@ -64,6 +67,13 @@ public:
     void add(const Disman::OutputPtr& output);
     void remove(int outputId);
 
+    /**
+     * Points the rows at the outputs of @p config if it has the same outputs as the current rows.
+     * Only rows with different settings are announced in full. Returns false without changing
+     * anything when the outputs differ.
+     */
+    bool replaceConfig(const Disman::ConfigPtr& config);
+
     /**
      * Resets the origin for calculation of positions to the most northwest display corner
      * while keeping the normalized positions untouched.
@@ -73,6 +83,11 @@ public:
     bool normalizePositions();
     bool positionsNormalized() const;
 
+    /**
+     * Sorts the rows by the outputs' positions, from west to east and then from north to south.
+     */
+    void updateOrder();
+
 Q_SIGNALS:
     void positionChanged();
     void sizeChanged();
@@ -116,7 +131,6 @@ private:
     void resetPosition(const Output& output);
     void reposition();
     void updatePositions();
-    void updateOrder();
     QPoint originDelta() const;
 
     /**
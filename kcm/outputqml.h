@@ -0,0 +1,20 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <disman/output.h>
+
+#include <QQmlEngine>
+
+/**
+ * Static QML declaration of Disman's Output, so the KCM's QML can use its enums. Disman does not
+ * declare its types for QML itself.
+ */
+struct OutputForeign {
+    Q_GADGET
+    QML_FOREIGN(Disman::Output)
+    QML_NAMED_ELEMENT(Output)
+};
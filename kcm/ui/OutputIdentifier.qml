@@ -25,9 +25,9 @@ Rectangle {
     property string outputName;
     property string modeName;
 
-    color: theme.backgroundColor
+    color: Kirigami.Theme.backgroundColor
     border {
-        color: theme.textColor
+        color: Kirigami.Theme.textColor
         width: Kirigami.Units.smallSpacing * 1.5
     }
     radius: Kirigami.Units.smallSpacing * 2
@@ -38,9 +38,9 @@ Rectangle {
 
     Kirigami.Label {
         id: displayName
-        x: units.largeSpacing * 2
-        y: units.largeSpacing
-        font.pointSize: theme.defaultFont.pointSize * 3
+        x: Kirigami.Units.largeSpacing * 2
+        y: Kirigami.Units.largeSpacing
+        font.pointSize: Kirigami.Theme.defaultFont.pointSize * 3
         text: root.outputName;
         wrapMode: Text.WordWrap;
         horizontalAlignment: Text.AlignHCenter;
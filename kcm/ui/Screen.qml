@@ -77,7 +77,7 @@ QQC2.ScrollView {
 
     Repeater {
         model: kcm.outputModel
-        delegate: Output {}
+        delegate: OutputDelegate {}
 
         onCountChanged: resetTotalSize()
     }
@@ -0,0 +1,337 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "cli.h"
+
+#include "../kded/generator.h"
+#include "../osd/osdaction.h"
+
+#include <disman/config.h>
+#include <disman/mode.h>
+#include <disman/output.h>
+
+#include <KLocalizedString>
+
+#include <QJsonArray>
+#include <QMetaEnum>
+#include <QTextStream>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace Cli
+{
+
+static constexpr std::array<std::pair<char const*, Disman::Output::Rotation>, 4> rotations{{
+    {"none", Disman::Output::Rotation::None},
+    {"left", Disman::Output::Rotation::Left},
+    {"inverted", Disman::Output::Rotation::Inverted},
+    {"right", Disman::Output::Rotation::Right},
+}};
+
+static QString rotationName(Disman::Output::Rotation rotation)
+{
+    for (auto const& [name, value] : rotations) {
+        if (value == rotation) {
+            return QString::fromLatin1(name);
+        }
+    }
+    return {};
+}
+
+static Disman::OutputPtr primaryOutput(Disman::ConfigPtr const& config)
+{
+    if (!(config->supported_features() & Disman::Config::Feature::PrimaryDisplay)) {
+        return nullptr;
+    }
+    return config->primary_output();
+}
+
+QJsonObject describe(Disman::ConfigPtr const& config)
+{
+    auto const outputs = config->outputs();
+    auto const primary = primaryOutput(config);
+
+    QJsonArray entries;
+    for (auto const& [id, output] : outputs) {
+        QJsonObject entry{
+            {QStringLiteral("id"), id},
+            {QStringLiteral("name"), QString::fromStdString(output->name())},
+            {QStringLiteral("description"), QString::fromStdString(output->description())},
+            {QStringLiteral("hash"), QString::fromStdString(output->hash())},
+            {QStringLiteral("enabled"), output->enabled()},
+        };
+        if (!output->enabled()) {
+            entries.append(entry);
+            continue;
+        }
+
+        auto const position = output->position();
+        entry[QStringLiteral("position")]
+            = QJsonObject{{QStringLiteral("x"), position.x()}, {QStringLiteral("y"), position.y()}};
+        if (auto const mode = output->auto_mode()) {
+            entry[QStringLiteral("mode")] = QJsonObject{
+                {QStringLiteral("id"), QString::fromStdString(mode->id())},
+                {QStringLiteral("width"), mode->size().width()},
+                {QStringLiteral("height"), mode->size().height()},
+                {QStringLiteral("refresh"), mode->refresh() / 1000.},
+            };
+        }
+        entry[QStringLiteral("scale")] = output->scale();
+        entry[QStringLiteral("rotation")] = rotationName(output->rotation());
+        entry[QStringLiteral("adaptiveSync")] = output->adaptive_sync();
+
+        if (auto const source = output->replication_source()) {
+            auto const it = outputs.find(source);
+            if (it != outputs.end()) {
+                entry[QStringLiteral("replicationSource")]
+                    = QString::fromStdString(it->second->name());
+            }
+        }
+        entries.append(entry);
+    }
+
+    QJsonObject description{{QStringLiteral("outputs"), entries}};
+    if (primary) {
+        description[QStringLiteral("primary")] = QString::fromStdString(primary->name());
+    }
+    return description;
+}
+
+QString describeText(Disman::ConfigPtr const& config)
+{
+    auto const primary = primaryOutput(config);
+
+    QString text;
+    QTextStream stream(&text);
+    for (auto const& [id, output] : config->outputs()) {
+        stream << QString::fromStdString(output->name());
+        if (!output->description().empty()) {
+            stream << " (" << QString::fromStdString(output->description()) << ")";
+        }
+        if (!output->enabled()) {
+            stream << ": disabled\n";
+            continue;
+        }
+
+        stream << ":";
+        if (auto const mode = output->auto_mode()) {
+            stream << " " << mode->size().width() << "x" << mode->size().height() << "@"
+                   << QString::number(mode->refresh() / 1000., 'f', 2);
+        }
+        auto const position = output->position();
+        stream << " at " << position.x() << "," << position.y() << " scale " << output->scale()
+               << " rotation " << rotationName(output->rotation());
+        if (output->adaptive_sync()) {
+            stream << " adaptive-sync";
+        }
+        if (output == primary) {
+            stream << " primary";
+        }
+        stream << "\n";
+    }
+    return text;
+}
+
+static QString checkApplicable(Disman::ConfigPtr const& config)
+{
+    auto const outputs = config->outputs();
+    auto const anyEnabled = std::any_of(outputs.cbegin(), outputs.cend(), [](auto const& entry) {
+        return entry.second->enabled();
+    });
+    if (!anyEnabled) {
+        return i18n("No output would be enabled.");
+    }
+    if (!Disman::Config::can_be_applied(config)) {
+        return i18n("The backend can not apply the layout.");
+    }
+    return {};
+}
+
+Result preset(QString const& presetName, Disman::ConfigPtr const& current)
+{
+    auto const actionEnum = QMetaEnum::fromType<KDisplay::OsdAction::Action>();
+
+    bool ok;
+    auto const action = static_cast<KDisplay::OsdAction::Action>(
+        actionEnum.keyToValue(qPrintable(presetName), &ok));
+    if (!ok || action == KDisplay::OsdAction::NoAction) {
+        return {nullptr, i18n("Unknown preset %1.", presetName)};
+    }
+
+    auto config = Generator::displaySwitch(action, current);
+    if (!config) {
+        return {nullptr, i18n("The preset %1 is not applicable.", presetName)};
+    }
+    auto error = checkApplicable(config);
+    return {error.isEmpty() ? config : nullptr, error};
+}
+
+static Disman::OutputPtr findOutput(Disman::ConfigPtr const& config, QJsonObject const& entry)
+{
+    auto const hash = entry.value(QStringLiteral("hash")).toString().toStdString();
+    auto const name = entry.value(QStringLiteral("name")).toString().toStdString();
+
+    for (auto const& [id, output] : config->outputs()) {
+        if (hash.empty() ? output->name() == name : output->hash() == hash) {
+            return output;
+        }
+    }
+    return nullptr;
+}
+
+static Disman::OutputPtr findOutput(Disman::ConfigPtr const& config, std::string const& name)
+{
+    for (auto const& [id, output] : config->outputs()) {
+        if (output->name() == name) {
+            return output;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * The mode with the id in @p entry or else the one with its size closest to its refresh rate.
+ * Without a refresh rate the highest is taken, without a size the current one.
+ */
+static Disman::ModePtr findMode(Disman::OutputPtr const& output, QJsonObject const& entry)
+{
+    auto const modes = output->modes();
+
+    if (entry.contains(QStringLiteral("id"))) {
+        auto const it = modes.find(entry.value(QStringLiteral("id")).toString().toStdString());
+        return it == modes.end() ? nullptr : it->second;
+    }
+
+    auto const current = output->auto_mode();
+    auto const size = QSize(
+        entry.value(QStringLiteral("width")).toInt(current ? current->size().width() : 0),
+        entry.value(QStringLiteral("height")).toInt(current ? current->size().height() : 0));
+    auto const refresh = entry.contains(QStringLiteral("refresh"))
+        ? std::lround(entry.value(QStringLiteral("refresh")).toDouble() * 1000)
+        : std::numeric_limits<int>::max();
+
+    Disman::ModePtr best;
+    for (auto const& [id, mode] : modes) {
+        if (mode->size() != size) {
+            continue;
+        }
+        if (!best || std::abs(mode->refresh() - refresh) < std::abs(best->refresh() - refresh)) {
+            best = mode;
+        }
+    }
+    return best;
+}
+
+static QString applyOutput(Disman::ConfigPtr const& config,
+                           Disman::OutputPtr const& output,
+                           QJsonObject const& entry)
+{
+    auto const name = QString::fromStdString(output->name());
+
+    if (entry.contains(QStringLiteral("enabled"))) {
+        output->set_enabled(entry.value(QStringLiteral("enabled")).toBool());
+    }
+    if (entry.contains(QStringLiteral("mode"))) {
+        auto const mode = findMode(output, entry.value(QStringLiteral("mode")).toObject());
+        if (!mode) {
+            return i18n("Output %1 has no such mode.", name);
+        }
+        // Keeps the auto flags when a layout is applied as it was listed.
+        if (auto const current = output->auto_mode(); !current || current->id() != mode->id()) {
+            output->set_mode(mode);
+            output->set_auto_resolution(false);
+            output->set_auto_refresh_rate(false);
+        }
+    }
+    if (entry.contains(QStringLiteral("position"))) {
+        auto const position = entry.value(QStringLiteral("position")).toObject();
+        output->set_position(QPointF(position.value(QStringLiteral("x")).toDouble(),
+                                     position.value(QStringLiteral("y")).toDouble()));
+    }
+    if (entry.contains(QStringLiteral("scale"))) {
+        auto const scale = entry.value(QStringLiteral("scale")).toDouble();
+        if (scale <= 0) {
+            return i18n("Output %1 needs a positive scale.", name);
+        }
+        output->set_scale(scale);
+    }
+    if (entry.contains(QStringLiteral("rotation"))) {
+        auto const rotation = entry.value(QStringLiteral("rotation")).toString();
+        auto const it = std::find_if(
+            rotations.cbegin(), rotations.cend(), [&rotation](auto const& candidate) {
+                return rotation == QLatin1String(candidate.first);
+            });
+        if (it == rotations.cend()) {
+            return i18n("Unknown rotation %1.", rotation);
+        }
+        output->set_rotation(it->second);
+    }
+    if (entry.contains(QStringLiteral("adaptiveSync"))) {
+        output->set_adaptive_sync(entry.value(QStringLiteral("adaptiveSync")).toBool());
+    }
+    if (entry.contains(QStringLiteral("replicationSource"))) {
+        auto const sourceName
+            = entry.value(QStringLiteral("replicationSource")).toString().toStdString();
+        if (sourceName.empty()) {
+            output->set_replication_source(0);
+        } else {
+            auto const source = findOutput(config, sourceName);
+            if (!source || source == output) {
+                return i18n(
+                    "Output %1 can not replicate %2.", name, QString::fromStdString(sourceName));
+            }
+            output->set_replication_source(source->id());
+        }
+    }
+    return {};
+}
+
+Result layout(QJsonObject const& layout, Disman::ConfigPtr const& current)
+{
+    auto config = current->clone();
+
+    if (layout.contains(QStringLiteral("preset"))) {
+        auto generated = preset(layout.value(QStringLiteral("preset")).toString(), config);
+        if (!generated.config) {
+            return generated;
+        }
+        config = generated.config;
+    }
+
+    for (auto const& value : layout.value(QStringLiteral("outputs")).toArray()) {
+        auto const entry = value.toObject();
+        auto const output = findOutput(config, entry);
+        if (!output) {
+            return {nullptr,
+                    i18n("There is no output %1.", entry.value(QStringLiteral("name")).toString())};
+        }
+        if (auto const error = applyOutput(config, output, entry); !error.isEmpty()) {
+            return {nullptr, error};
+        }
+    }
+
+    if (layout.contains(QStringLiteral("primary"))) {
+        if (!(config->supported_features() & Disman::Config::Feature::PrimaryDisplay)) {
+            return {nullptr, i18n("The backend has no primary output.")};
+        }
+        auto const name = layout.value(QStringLiteral("primary")).toString();
+        auto const primary = findOutput(config, name.toStdString());
+        if (!primary) {
+            return {nullptr, i18n("There is no output %1.", name)};
+        }
+        config->set_primary_output(primary);
+    }
+
+    config->set_cause(Disman::Config::Cause::interactive);
+
+    auto error = checkApplicable(config);
+    return {error.isEmpty() ? config : nullptr, error};
+}
+
+}
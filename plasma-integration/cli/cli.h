@@ -0,0 +1,58 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <disman/types.h>
+
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * The commands of kdisplay-cli, which changes the layout from scripts without any UI.
+ *
+ * Layouts are JSON objects in the format describe() returns, so the output of listing the
+ * outputs can be edited and applied again:
+ *
+ *   {
+ *     "preset": "ExtendLeft",
+ *     "primary": "eDP-1",
+ *     "outputs": [
+ *       {"name": "eDP-1", "enabled": true, "position": {"x": 0, "y": 0},
+ *        "mode": {"width": 1920, "height": 1080, "refresh": 60}, "scale": 1.5,
+ *        "rotation": "none", "adaptiveSync": false},
+ *       {"name": "HDMI-1", "replicationSource": "eDP-1"}
+ *     ]
+ *   }
+ *
+ * Every key is optional. The preset is generated first, the same way the daemon generates it for
+ * the OSD, and the outputs are changed on top of it. Outputs are matched by their hash when the
+ * entry has one and by name otherwise. Settings an entry leaves out stay as they are.
+ */
+namespace Cli
+{
+
+QJsonObject describe(Disman::ConfigPtr const& config);
+QString describeText(Disman::ConfigPtr const& config);
+
+/**
+ * A config to apply or why there is none.
+ */
+struct Result {
+    Disman::ConfigPtr config;
+    QString error;
+};
+
+/**
+ * Generates @p presetName, a key of OsdAction::Action, from @p current.
+ */
+Result preset(QString const& presetName, Disman::ConfigPtr const& current);
+
+/**
+ * Changes a copy of @p current as @p layout describes and checks that it can be applied.
+ */
+Result layout(QJsonObject const& layout, Disman::ConfigPtr const& current);
+
+}
@@ -0,0 +1,162 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "cli.h"
+
+#include "../../common/fingerprint.h"
+
+#include <disman/config.h>
+#include <disman/getconfigoperation.h>
+#include <disman/setconfigoperation.h>
+
+#include <KLocalizedString>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+
+enum ExitCode {
+    Success = 0,
+    Failure = 1,
+    Usage = 2,
+};
+
+static bool s_json = false;
+
+static int fail(QString const& error, int code = Failure)
+{
+    if (s_json) {
+        QTextStream(stdout) << QJsonDocument(QJsonObject{{QStringLiteral("error"), error}})
+                                   .toJson(QJsonDocument::Compact)
+                            << Qt::endl;
+    } else {
+        QTextStream(stderr) << error << Qt::endl;
+    }
+    return code;
+}
+
+static int usage(QCommandLineParser const& parser)
+{
+    // Also with --json, where only results and errors of commands go to stdout.
+    QTextStream(stderr) << parser.helpText();
+    return Usage;
+}
+
+static bool readLayout(QString const& path, QJsonObject& layout, QString& error)
+{
+    QFile file(path);
+    auto const opened = path == QLatin1String("-") ? file.open(stdin, QIODevice::ReadOnly)
+                                                   : file.open(QIODevice::ReadOnly);
+    if (!opened) {
+        error = i18n("Could not read %1.", path);
+        return false;
+    }
+
+    QJsonParseError parseError;
+    auto const document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!document.isObject()) {
+        error = i18n("%1 is no layout: %2", path, parseError.errorString());
+        return false;
+    }
+    layout = document.object();
+    return true;
+}
+
+static int apply(Cli::Result const& result, uint64_t activeFingerprint, bool dryRun)
+{
+    if (!result.config) {
+        return fail(result.error);
+    }
+
+    // Like the daemon, nothing is done for a layout that is active already.
+    auto const changed = Fingerprint::config(result.config) != activeFingerprint;
+    auto applied = false;
+    if (changed && !dryRun) {
+        auto op = new Disman::SetConfigOperation(result.config);
+        if (!op->exec()) {
+            return fail(i18n("The backend failed to apply the layout."));
+        }
+        applied = true;
+    }
+
+    if (s_json) {
+        auto description = Cli::describe(result.config);
+        description[QStringLiteral("changed")] = changed;
+        description[QStringLiteral("applied")] = applied;
+        QTextStream(stdout) << QJsonDocument(description).toJson(QJsonDocument::Compact)
+                            << Qt::endl;
+    } else if (!changed) {
+        QTextStream(stdout) << i18n("The layout is active already.") << Qt::endl;
+    } else {
+        QTextStream(stdout) << Cli::describeText(result.config);
+    }
+    return Success;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("kdisplay-cli"));
+    QCoreApplication::setApplicationVersion(QStringLiteral(KDISPLAY_VERSION));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        i18n("Lists the outputs or changes their layout without a user interface."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption json(QStringLiteral("json"), i18n("Print JSON."));
+    QCommandLineOption dryRun(QStringLiteral("dry-run"),
+                              i18n("Check the layout but do not apply it."));
+    parser.addOptions({json, dryRun});
+
+    parser.addPositionalArgument(QStringLiteral("command"),
+                                 i18n("list, preset <name> or apply <file>. The file is a layout "
+                                      "as list --json prints it, - reads it from stdin."));
+    parser.process(app);
+
+    s_json = parser.isSet(json);
+
+    auto const arguments = parser.positionalArguments();
+    auto const command = arguments.value(0);
+    auto const expectedCount = command == QLatin1String("list") ? 1 : 2;
+    if (arguments.size() != expectedCount
+        || (expectedCount == 2 && command != QLatin1String("preset")
+            && command != QLatin1String("apply"))) {
+        return usage(parser);
+    }
+
+    auto op = new Disman::GetConfigOperation;
+    if (!op->exec()) {
+        qWarning() << op->error_string();
+        return fail(i18n("Could not read the current layout."));
+    }
+    auto const current = op->config();
+    // Taken before generating from the config.
+    auto const activeFingerprint = Fingerprint::config(current);
+
+    if (command == QLatin1String("list")) {
+        if (s_json) {
+            QTextStream(stdout) << QJsonDocument(Cli::describe(current)).toJson() << Qt::flush;
+        } else {
+            QTextStream(stdout) << Cli::describeText(current) << Qt::flush;
+        }
+        return Success;
+    }
+
+    if (command == QLatin1String("preset")) {
+        return apply(
+            Cli::preset(arguments.at(1), current), activeFingerprint, parser.isSet(dryRun));
+    }
+
+    QJsonObject layout;
+    QString error;
+    if (!readLayout(arguments.at(1), layout, error)) {
+        return fail(error);
+    }
+    return apply(Cli::layout(layout, current), activeFingerprint, parser.isSet(dryRun));
+}
@@ -0,0 +1,242 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "apply_scheduler.h"
+
+#include "kdisplay_daemon_debug.h"
+
+#include <algorithm>
+
+using namespace std::chrono;
+
+static constexpr std::array<char const*, 3> priority_names{
+    "sensor",
+    "hotplug",
+    "user",
+};
+
+ApplyScheduler::ApplyScheduler(Apply apply)
+    : m_apply{std::move(apply)}
+{
+    static_assert(priority_names.size() == priority_count);
+
+    m_retryTimer.setSingleShot(true);
+    QObject::connect(&m_retryTimer, &QTimer::timeout, &m_retryTimer, [this] { dispatch(); });
+}
+
+void ApplyScheduler::submit(Priority priority, QString const& key, Make make, Done done)
+{
+    statistics(priority).requests++;
+
+    // Taken out first since their callbacks may submit again.
+    std::vector<Request> replaced;
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->key == key) {
+            statistics(it->priority).superseded++;
+        } else if (priority == Priority::User && it->priority == Priority::Sensor) {
+            qCDebug(KDISPLAY_KDED) << "Dropping" << it->key << "for a user request";
+            statistics(it->priority).dropped++;
+        } else {
+            ++it;
+            continue;
+        }
+        replaced.push_back(std::move(*it));
+        it = m_pending.erase(it);
+    }
+
+    m_pending.push_back({priority, key, std::move(make), std::move(done), Clock::now()});
+    m_maxDepth = std::max(m_maxDepth, depth());
+
+    for (auto& request : replaced) {
+        complete(request, Outcome::Superseded);
+    }
+    dispatch();
+}
+
+bool ApplyScheduler::finished(uint64_t id, bool success)
+{
+    // A later apply can finish first, like a user request started while a sensor one applies.
+    auto const it = std::find_if(m_inFlight.begin(), m_inFlight.end(), [id](auto const& request) {
+        return request.id == id;
+    });
+    if (it == m_inFlight.end()) {
+        return false;
+    }
+
+    auto request = std::move(*it);
+    m_inFlight.erase(it);
+    auto const inFlight = m_inFlight.size();
+
+    if (request.superseded) {
+        complete(request, Outcome::Superseded);
+    } else if (success) {
+        complete(request, Outcome::Applied);
+    } else if (request.retries < max_retries) {
+        auto const delay = first_retry_delay * (1 << request.retries);
+        qCDebug(KDISPLAY_KDED) << "Apply of" << request.key << "failed, retrying in"
+                               << delay.count() << "ms";
+        request.retries++;
+        request.due = Clock::now() + delay;
+        statistics(request.priority).retries++;
+        m_pending.push_back(std::move(request));
+        m_maxDepth = std::max(m_maxDepth, depth());
+    } else {
+        qCWarning(KDISPLAY_KDED) << "Apply of" << request.key << "failed, giving up";
+        complete(request, Outcome::Failed);
+    }
+
+    dispatch();
+    return m_inFlight.size() > inFlight;
+}
+
+bool ApplyScheduler::busy() const
+{
+    return !m_inFlight.empty();
+}
+
+int ApplyScheduler::depth() const
+{
+    return m_pending.size();
+}
+
+void ApplyScheduler::dispatch()
+{
+    // Requests submitted by callbacks on the way are picked up by the loop.
+    if (m_dispatching) {
+        return;
+    }
+    m_dispatching = true;
+
+    for (;;) {
+        // The highest priority first, in the order of submission.
+        auto const now = Clock::now();
+        auto next = m_pending.end();
+        for (auto it = m_pending.begin(); it != m_pending.end(); ++it) {
+            if (it->due <= now && (next == m_pending.end() || it->priority > next->priority)) {
+                next = it;
+            }
+        }
+        if (next == m_pending.end()) {
+            break;
+        }
+
+        auto const priority = next->priority;
+        if (std::any_of(m_inFlight.cbegin(), m_inFlight.cend(), [priority](auto const& request) {
+                return !request.superseded && request.priority >= priority;
+            })) {
+            break;
+        }
+
+        auto request = std::move(*next);
+        m_pending.erase(next);
+        start(std::move(request));
+    }
+
+    m_dispatching = false;
+    scheduleRetry();
+}
+
+void ApplyScheduler::start(Request request)
+{
+    if (!request.retries) {
+        auto& stats = statistics(request.priority);
+        auto const wait = duration_cast<microseconds>(Clock::now() - request.submitted).count();
+        stats.waits++;
+        stats.waitSum += wait;
+        stats.waitMax = std::max(stats.waitMax, static_cast<int64_t>(wait));
+
+        auto config = request.make();
+        if (!config) {
+            complete(request, Outcome::Failed);
+            return;
+        }
+        request.config = std::move(*config);
+    }
+
+    if (!request.config) {
+        complete(request, Outcome::Skipped);
+        return;
+    }
+    request.id = ++m_lastId;
+    if (!m_apply(request.config, request.id)) {
+        complete(request, Outcome::Unchanged);
+        return;
+    }
+
+    for (auto& applying : m_inFlight) {
+        if (!applying.superseded && applying.priority < request.priority) {
+            applying.superseded = true;
+            statistics(applying.priority).superseded++;
+        }
+    }
+    m_inFlight.push_back(std::move(request));
+}
+
+void ApplyScheduler::complete(Request& request, Outcome outcome)
+{
+    if (outcome == Outcome::Skipped) {
+        statistics(request.priority).skipped++;
+    } else if (outcome == Outcome::Failed) {
+        statistics(request.priority).failed++;
+    }
+    if (request.done) {
+        request.done(outcome);
+    }
+}
+
+void ApplyScheduler::scheduleRetry()
+{
+    // Retries that are due already wait for an apply in flight and start once it finished.
+    auto const now = Clock::now();
+    auto due = Clock::time_point::max();
+    for (auto const& request : m_pending) {
+        if (request.due > now) {
+            due = std::min(due, request.due);
+        }
+    }
+
+    if (due == Clock::time_point::max()) {
+        m_retryTimer.stop();
+        return;
+    }
+    m_retryTimer.start(std::chrono::ceil<milliseconds>(due - now));
+}
+
+ApplyScheduler::PriorityStatistics& ApplyScheduler::statistics(Priority priority)
+{
+    return m_statistics[static_cast<size_t>(priority)];
+}
+
+QVariantMap ApplyScheduler::toVariantMap() const
+{
+    QVariantMap map{
+        {QStringLiteral("depth"), depth()},
+        {QStringLiteral("maxDepth"), m_maxDepth},
+        {QStringLiteral("inFlight"), static_cast<int>(m_inFlight.size())},
+    };
+
+    for (size_t i = 0; i < priority_count; i++) {
+        auto const& stats = m_statistics[i];
+        map.insert(QString::fromLatin1(priority_names[i]),
+                   QVariantMap{
+                       {QStringLiteral("requests"), static_cast<qulonglong>(stats.requests)},
+                       {QStringLiteral("superseded"), static_cast<qulonglong>(stats.superseded)},
+                       {QStringLiteral("dropped"), static_cast<qulonglong>(stats.dropped)},
+                       {QStringLiteral("retries"), static_cast<qulonglong>(stats.retries)},
+                       {QStringLiteral("skipped"), static_cast<qulonglong>(stats.skipped)},
+                       {QStringLiteral("failed"), static_cast<qulonglong>(stats.failed)},
+                       {QStringLiteral("waits"), static_cast<qulonglong>(stats.waits)},
+                       {QStringLiteral("waitSum"), static_cast<qlonglong>(stats.waitSum)},
+                       {QStringLiteral("waitMax"), static_cast<qlonglong>(stats.waitMax)},
+                   });
+    }
+    return map;
+}
+
+void ApplyScheduler::resetStatistics()
+{
+    m_statistics = {};
+    m_maxDepth = depth();
+}
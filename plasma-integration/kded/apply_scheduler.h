@@ -0,0 +1,147 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <disman/types.h>
+
+#include <QString>
+#include <QTimer>
+#include <QVariantMap>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+/**
+ * Orders the applies the daemon is asked for. Requests come with a priority and a key, the
+ * config of a request is only made once it is its turn, against the config at that time.
+ *
+ * - A request is started right away when nothing of the same or a higher priority is applying.
+ *   Applies of a lower priority still in flight are superseded by it, the backend applies in
+ *   order.
+ * - Otherwise it waits, and replaces a waiting request with the same key.
+ * - A user request drops all waiting sensor requests, the layout the user picked stays as is.
+ * - A failed apply is tried again a few times with a growing delay, unless replaced meanwhile.
+ */
+class ApplyScheduler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Priority {
+        // Follows the device, like the orientation sensor.
+        Sensor,
+        // Follows the hardware that was plugged, like the lid, or the power source.
+        Hotplug,
+        // What the user asked for through the OSD, a shortcut or D-Bus.
+        User,
+    };
+
+    enum class Outcome {
+        Applied,
+        // The config equals the active one.
+        Unchanged,
+        // There was nothing to apply, like an OSD that was cancelled.
+        Skipped,
+        // No config could be made, or it still failed on the last try.
+        Failed,
+        // Replaced by a later request, either before it started or while it was applying.
+        Superseded,
+    };
+
+    /**
+     * Makes the config to apply, null when there is nothing to apply and no value when it could
+     * not be made.
+     */
+    using Make = std::function<std::optional<Disman::ConfigPtr>()>;
+    using Done = std::function<void(Outcome)>;
+    /**
+     * Starts applying @p config. Returns false when there was nothing to apply. The apply is
+     * identified by @p id when it finished.
+     */
+    using Apply = std::function<bool(Disman::ConfigPtr const& config, uint64_t id)>;
+
+    static constexpr int max_retries = 3;
+    // Doubled on each retry.
+    static constexpr std::chrono::milliseconds first_retry_delay{100};
+
+    explicit ApplyScheduler(Apply apply);
+
+    /**
+     * @p done is called once with the outcome. That can be before this returns.
+     */
+    void submit(Priority priority, QString const& key, Make make, Done done = {});
+
+    /**
+     * To be called when the apply @p id that the scheduler started finished, in any order.
+     * Returns whether another apply was started.
+     */
+    bool finished(uint64_t id, bool success);
+
+    /**
+     * Whether an apply is in flight.
+     */
+    bool busy() const;
+    /**
+     * Requests waiting for their turn or for a retry.
+     */
+    int depth() const;
+
+    /**
+     * The current and the highest depth, and per priority how requests went and how long they
+     * waited until started. Times are in microseconds.
+     */
+    QVariantMap toVariantMap() const;
+    void resetStatistics();
+
+private:
+    static constexpr size_t priority_count = static_cast<size_t>(Priority::User) + 1;
+
+    struct Request {
+        Priority priority;
+        QString key;
+        Make make;
+        Done done;
+        Clock::time_point submitted;
+        // Kept for retries, so they apply what failed.
+        Disman::ConfigPtr config;
+        uint64_t id{0};
+        int retries{0};
+        Clock::time_point due;
+        bool superseded{false};
+    };
+
+    struct PriorityStatistics {
+        uint64_t requests{0};
+        uint64_t superseded{0};
+        uint64_t dropped{0};
+        uint64_t retries{0};
+        uint64_t skipped{0};
+        uint64_t failed{0};
+        uint64_t waits{0};
+        int64_t waitSum{0};
+        int64_t waitMax{0};
+    };
+
+    void dispatch();
+    void start(Request request);
+    void complete(Request& request, Outcome outcome);
+    void scheduleRetry();
+    PriorityStatistics& statistics(Priority priority);
+
+    Apply m_apply;
+    std::vector<Request> m_pending;
+    std::vector<Request> m_inFlight;
+    bool m_dispatching{false};
+    uint64_t m_lastId{0};
+    QTimer m_retryTimer;
+
+    std::array<PriorityStatistics, priority_count> m_statistics{};
+    int m_maxDepth{0};
+};
@@ -8,12 +8,17 @@
 */
 #include "daemon.h"
 
+#include "../../common/fingerprint.h"
 #include "../../common/orientation_sensor.h"
+#include "../../common/snapshot.h"
+#include "../../common/trace.h"
+#include "../../common/utils.h"
 #include "config.h"
 #include "generator.h"
 #include "kdisplay_daemon_debug.h"
 #include "kdisplayadaptor.h"
 #include "osdservice_interface.h"
+#include "upower.h"
 
 #include <disman/configmonitor.h>
 #include <disman/getconfigoperation.h>
@@ -27,15 +32,35 @@
 #include <KPluginFactory>
 
 #include <QAction>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QElapsedTimer>
 #include <QOrientationReading>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <utility>
+
 K_PLUGIN_CLASS_WITH_JSON(KDisplayDaemon, "kdisplayd.json")
 
 KDisplayDaemon::KDisplayDaemon(QObject* parent, const QList<QVariant>&)
+    : KDisplayDaemon(parent, new OrientationSensor, QDBusConnection::systemBus())
+{
+    m_globalShortcut = true;
+}
+
+KDisplayDaemon::KDisplayDaemon(QObject* parent,
+                               OrientationSensor* orientationSensor,
+                               QDBusConnection const& systemBus)
     : KDEDModule(parent)
     , m_monitoring{false}
-    , m_orientationSensor(new OrientationSensor(this))
+    , m_orientationSensor(orientationSensor)
+    , m_upower(new UPower(systemBus, this))
+    , m_scheduler([this](auto const& config, auto id) { return doApplyConfig(config, id); })
 {
+    m_orientationSensor->setParent(this);
     Disman::Log::instance();
     qMetaTypeId<KDisplay::OsdAction>();
 
@@ -53,20 +78,29 @@ void KDisplayDaemon::init(Disman::ConfigOperation* op)
     }
 
     m_monitoredConfig = qobject_cast<Disman::GetConfigOperation*>(op)->config();
+    m_activeFingerprint = Fingerprint::config(m_monitoredConfig);
     auto cfg = m_monitoredConfig.get();
 
     qCDebug(KDISPLAY_KDED) << "Config" << cfg << "is ready";
     Disman::ConfigMonitor::instance()->add_config(m_monitoredConfig);
 
+    m_profileStore.load();
+
     update_auto_rotate();
+    updateSummary();
+    updateSnapshot();
+    updateLidLayouts();
     setMonitorForChanges(true);
 
-    KActionCollection* coll = new KActionCollection(this);
-    QAction* action = coll->addAction(QStringLiteral("display"));
-    action->setText(i18n("Switch Display"));
-    QList<QKeySequence> switchDisplayShortcuts({Qt::Key_Display, Qt::MetaModifier | Qt::Key_P});
-    KGlobalAccel::self()->setGlobalShortcut(action, switchDisplayShortcuts);
-    connect(action, &QAction::triggered, this, &KDisplayDaemon::displayButton);
+    if (m_globalShortcut) {
+        KActionCollection* coll = new KActionCollection(this);
+        QAction* action = coll->addAction(QStringLiteral("display"));
+        action->setText(i18n("Switch Display"));
+        QList<QKeySequence> switchDisplayShortcuts(
+            {Qt::Key_Display, Qt::MetaModifier | Qt::Key_P});
+        KGlobalAccel::self()->setGlobalShortcut(action, switchDisplayShortcuts);
+        connect(action, &QAction::triggered, this, &KDisplayDaemon::displayButton);
+    }
 
     new KdisplayAdaptor(this);
 
@@ -79,8 +113,8 @@ void KDisplayDaemon::init(Disman::ConfigOperation* op)
     m_osdServiceInterface->setTimeout(
         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::seconds(60)).count());
 
-    connect(cfg, &Disman::Config::output_added, this, &KDisplayDaemon::applyConfig);
-    connect(cfg, &Disman::Config::output_removed, this, &KDisplayDaemon::applyConfig);
+    connect(cfg, &Disman::Config::output_added, this, &KDisplayDaemon::hotplug);
+    connect(cfg, &Disman::Config::output_removed, this, &KDisplayDaemon::hotplug);
 
     connect(m_orientationSensor,
             &OrientationSensor::availableChanged,
@@ -91,6 +125,16 @@ void KDisplayDaemon::init(Disman::ConfigOperation* op)
             this,
             &KDisplayDaemon::updateOrientation);
 
+    connect(m_upower, &UPower::lidPresentChanged, this, &KDisplayDaemon::updateLidLayouts);
+    connect(m_upower, &UPower::lidClosedChanged, this, &KDisplayDaemon::lidClosedChanged);
+    connect(m_upower, &UPower::onBatteryChanged, this, &KDisplayDaemon::onBatteryChanged);
+    connect(m_upower, &UPower::ready, this, &KDisplayDaemon::reconcileRefreshRates);
+    followClosedLid();
+    if (m_upower->onBattery()) {
+        onBatteryChanged(true);
+    }
+    reconcileRefreshRates();
+
     applyConfig();
 
     m_startingUp = false;
@@ -117,6 +161,7 @@ void KDisplayDaemon::updateOrientation()
     }
 
     const auto orientation = m_orientationSensor->value();
+    record(FlightRecorder::Event::Orientation, orientation);
     if (orientation == QOrientationReading::Undefined) {
         // Orientation sensor went off. Do not change current orientation.
         return;
@@ -128,58 +173,258 @@ void KDisplayDaemon::updateOrientation()
         return;
     }
 
-    Config(m_monitoredConfig).setDeviceOrientation(orientation);
-    if (m_monitoring) {
-        doApplyConfig(m_monitoredConfig);
+    Trace::instant("kded", "orientationChanged");
+    m_scheduler.submit(
+        ApplyScheduler::Priority::Sensor,
+        QStringLiteral("orientation"),
+        [this, orientation] {
+            Config(m_monitoredConfig).setDeviceOrientation(orientation);
+            return m_monitoredConfig;
+        },
+        [this](auto outcome) {
+            if (outcome == ApplyScheduler::Outcome::Applied) {
+                m_statistics.count(Statistics::Counter::OrientationApplies);
+            }
+        });
+}
+
+void KDisplayDaemon::updateLidLayouts()
+{
+    m_lidClosedConfig = nullptr;
+    m_lidOpenedConfig = nullptr;
+    if (!m_monitoredConfig || !m_upower->lidPresent()) {
+        m_layoutBeforeLidClosed = nullptr;
+        return;
+    }
+
+    Trace::Span span("kded", "updateLidLayouts");
+    m_lidLayoutsFingerprint = Fingerprint::config(m_monitoredConfig);
+
+    // Both are prepared ahead, so a lid event is answered with an apply right away.
+    m_lidClosedConfig = Generator::lidClosed(m_monitoredConfig);
+    if (m_layoutBeforeLidClosed
+        && Fingerprint::setup(m_layoutBeforeLidClosed) == Fingerprint::setup(m_monitoredConfig)) {
+        m_lidOpenedConfig = m_layoutBeforeLidClosed;
     } else {
-        m_configDirty = true;
+        m_layoutBeforeLidClosed = nullptr;
+        m_lidOpenedConfig = Generator::lidOpened(m_monitoredConfig);
     }
 }
 
-void KDisplayDaemon::doApplyConfig(Disman::ConfigPtr const& config)
+void KDisplayDaemon::lidClosedChanged(bool closed)
 {
-    qCDebug(KDISPLAY_KDED) << "Do set and apply specific config";
+    if (!m_monitoredConfig) {
+        return;
+    }
+
+    Trace::instant("kded", closed ? "lidClosed" : "lidOpened");
+    record(FlightRecorder::Event::Lid, closed);
+
+    auto const make = [this, closed] {
+        // The layouts are from before a change that is not through yet, like an apply in flight.
+        if (Fingerprint::config(m_monitoredConfig) != m_lidLayoutsFingerprint) {
+            updateLidLayouts();
+        }
+
+        if (closed) {
+            m_layoutBeforeLidClosed = m_monitoredConfig->clone();
+            return std::exchange(m_lidClosedConfig, nullptr);
+        }
+        m_layoutBeforeLidClosed = nullptr;
+        return std::exchange(m_lidOpenedConfig, nullptr);
+    };
+    m_scheduler.submit(
+        ApplyScheduler::Priority::Hotplug, QStringLiteral("lid"), make, [this](auto outcome) {
+            if (outcome == ApplyScheduler::Outcome::Applied) {
+                m_statistics.count(Statistics::Counter::LidApplies);
+            }
+        });
+}
+
+void KDisplayDaemon::followClosedLid()
+{
+    // UPower only reports changes. The lid may have been closed before we listened, and a
+    // hotplug may bring a layout with the panel on while it is closed.
+    if (m_upower->lidClosed() && m_lidClosedConfig) {
+        lidClosedChanged(true);
+    }
+}
+
+void KDisplayDaemon::onBatteryChanged(bool onBattery)
+{
+    if (!m_monitoredConfig) {
+        return;
+    }
+
+    Trace::instant("kded", onBattery ? "onBattery" : "onAc");
+    record(FlightRecorder::Event::PowerSource, onBattery);
+    submitRefreshPolicy(onBattery);
+}
+
+void KDisplayDaemon::reconcileRefreshRates()
+{
+    // Rates still lowered from a run that ended on battery, like after a crash or a logout.
+    if (m_monitoredConfig && m_upower->isReady() && !m_upower->onBattery()
+        && m_refreshPolicy.lowered()) {
+        submitRefreshPolicy(false);
+    }
+}
+
+void KDisplayDaemon::submitRefreshPolicy(bool onBattery)
+{
+    auto const request = ++m_lastPowerRequest;
+    auto const make = [this, onBattery]() -> Disman::ConfigPtr {
+        // All outputs at once, so there is a single apply.
+        auto config = m_monitoredConfig->clone();
+        auto const changed
+            = onBattery ? m_refreshPolicy.lower(config) : m_refreshPolicy.restore(config);
+        return changed ? config : nullptr;
+    };
+    // Not dropped for user requests like sensor data, the power source stays as it is.
+    auto const done = [this, onBattery, request](auto outcome) {
+        switch (outcome) {
+        case ApplyScheduler::Outcome::Applied:
+            m_statistics.count(Statistics::Counter::PowerApplies);
+            [[fallthrough]];
+        case ApplyScheduler::Outcome::Unchanged:
+        case ApplyScheduler::Outcome::Skipped:
+            m_refreshPolicy.commit();
+            break;
+        case ApplyScheduler::Outcome::Superseded:
+            // By a layout applied meanwhile, which may have brought the rates back.
+            if (request == m_lastPowerRequest) {
+                submitRefreshPolicy(onBattery);
+            }
+            break;
+        case ApplyScheduler::Outcome::Failed:
+            break;
+        }
+    };
+    m_scheduler.submit(ApplyScheduler::Priority::Hotplug, QStringLiteral("power"), make, done);
+}
+
+bool KDisplayDaemon::doApplyConfig(Disman::ConfigPtr const& config, uint64_t applyId)
+{
+    Trace::Span span("kded", "doApplyConfig");
+
+    // For example the current layout picked again in the OSD, or the current orientation
+    // reported after a wakeup. Applying would only cost a backend round trip and maybe flicker.
+    if (m_activeFingerprint && Fingerprint::config(config) == m_activeFingerprint) {
+        qCDebug(KDISPLAY_KDED) << "Config equals the active one, not applying";
+        Trace::instant("kded", "applySkipped");
+        m_statistics.count(Statistics::Counter::SkippedApplies);
+        return false;
+    }
 
+    qCDebug(KDISPLAY_KDED) << "Do set and apply specific config";
     m_monitoredConfig->apply(config);
-    refreshConfig();
+    refreshConfig(applyId);
+    return true;
 }
 
-void KDisplayDaemon::refreshConfig()
+void KDisplayDaemon::refreshConfig(uint64_t applyId)
 {
     setMonitorForChanges(false);
-    m_configDirty = false;
     Disman::ConfigMonitor::instance()->add_config(m_monitoredConfig);
 
+    m_statistics.mark(Statistics::Event::Apply);
+    m_statistics.count(Statistics::Counter::Applies);
+    m_activeFingerprint = Fingerprint::config(m_monitoredConfig);
+
+    auto const traceId = ++m_traceId;
+    Trace::asyncBegin("kded", "setConfig", traceId);
+    record(FlightRecorder::Event::ApplyStarted);
+
     connect(new Disman::SetConfigOperation(m_monitoredConfig),
             &Disman::SetConfigOperation::finished,
             this,
-            [this]() {
+            [this, traceId, applyId](auto op) {
                 qCDebug(KDISPLAY_KDED) << "Config applied";
-                if (m_configDirty) {
-                    // Config changed in the meantime again, apply.
-                    doApplyConfig(m_monitoredConfig);
-                } else {
-                    setMonitorForChanges(true);
+                Trace::asyncEnd("kded", "setConfig", traceId);
+                m_statistics.mark(Statistics::Event::ApplyFinished);
+                record(FlightRecorder::Event::ApplyFinished, !op->has_error());
+                m_statistics.count(Statistics::Counter::FinishedApplies);
+                if (op->has_error()) {
+                    m_statistics.count(Statistics::Counter::FailedApplies);
+                    // Unclear what is active now, so don't skip the next apply.
+                    m_activeFingerprint = 0;
+                }
+
+                // Monitoring is off while applying, so the summary is only updated here.
+                updateSummary();
+                updateSnapshot();
+                updateLidLayouts();
+
+                // Requests that came in meanwhile are started now.
+                if (m_scheduler.finished(applyId, !op->has_error())) {
+                    m_statistics.count(Statistics::Counter::Reapplies);
+                }
+                if (m_scheduler.busy()) {
+                    return;
                 }
+                endHotplugTrace();
+                setMonitorForChanges(true);
             });
 }
 
+void KDisplayDaemon::hotplug()
+{
+    m_statistics.mark(Statistics::Event::Hotplug);
+    m_statistics.count(Statistics::Counter::Hotplugs);
+    m_activeFingerprint = Fingerprint::config(m_monitoredConfig);
+    updateSummary();
+    record(FlightRecorder::Event::Hotplug);
+    updateSnapshot();
+    updateLidLayouts();
+    followClosedLid();
+    if (m_upower->onBattery()) {
+        // For the outputs that came with it.
+        submitRefreshPolicy(true);
+    }
+
+    // Traces the time until the resulting layout is in place, including the user's choice in the
+    // OSD. Hotplugs in between are part of the same span.
+    if (!m_hotplugTraceId) {
+        m_hotplugTraceId = ++m_traceId;
+        Trace::asyncBegin("kded", "hotplug", m_hotplugTraceId);
+    }
+    applyConfig();
+}
+
+void KDisplayDaemon::endHotplugTrace()
+{
+    if (m_hotplugTraceId) {
+        Trace::asyncEnd("kded", "hotplug", m_hotplugTraceId);
+        m_hotplugTraceId = 0;
+    }
+}
+
 void KDisplayDaemon::applyConfig()
 {
     qCDebug(KDISPLAY_KDED) << "Applying config";
+    Trace::Span span("kded", "applyConfig");
 
     auto const should_show_osd = m_monitoredConfig->outputs().size() > 1 && !m_startingUp
         && m_monitoredConfig->cause() == Disman::Config::Cause::generated;
+    m_statistics.mark(Statistics::Event::Decision);
 
     if (should_show_osd) {
         qCDebug(KDISPLAY_KDED) << "Getting ideal config from user via OSD...";
         show_osd();
-    } else {
-        m_osdServiceInterface->hideOsd();
+        return;
+    }
+
+    m_osdServiceInterface->hideOsd();
+    endHotplugTrace();
+
+    if (m_monitoredConfig->outputs().size() > 1) {
+        // With multiple outputs the user may switch layouts soon. Start the OSD service early so
+        // it has its view ready when the shortcut is pressed.
+        m_osdServiceInterface->prepare();
     }
 }
 
-void KDisplayDaemon::applyLayoutPreset(const QString& presetName)
+static std::optional<KDisplay::OsdAction::Action> presetAction(QString const& presetName)
 {
     auto const actionEnum = QMetaEnum::fromType<KDisplay::OsdAction::Action>();
     Q_ASSERT(actionEnum.isValid());
@@ -189,9 +434,89 @@ void KDisplayDaemon::applyLayoutPreset(const QString& presetName)
         actionEnum.keyToValue(qPrintable(presetName), &ok));
     if (!ok) {
         qCWarning(KDISPLAY_KDED) << "Cannot apply unknown screen layout preset named" << presetName;
-        return;
+        return {};
+    }
+    return action;
+}
+
+void KDisplayDaemon::applyLayoutPreset(const QString& presetName)
+{
+    if (auto const action = presetAction(presetName)) {
+        applyOsdAction(*action);
+    }
+}
+
+uint KDisplayDaemon::requestLayoutPreset(const QString& presetName)
+{
+    auto const id = ++m_lastLayoutRequestId;
+    auto done = layoutRequest(id);
+
+    if (auto const action = presetAction(presetName)) {
+        applyOsdAction(*action, std::move(done));
+    } else {
+        done(ApplyScheduler::Outcome::Failed);
+    }
+    return id;
+}
+
+bool KDisplayDaemon::saveProfile(const QString& name)
+{
+    if (!m_monitoredConfig || !m_profileStore.save(name, m_monitoredConfig)) {
+        return false;
+    }
+    updateSummary();
+    return true;
+}
+
+bool KDisplayDaemon::removeProfile(const QString& name)
+{
+    if (!m_monitoredConfig || !m_profileStore.remove(name, m_monitoredConfig)) {
+        return false;
     }
-    applyOsdAction(action);
+    updateSummary();
+    return true;
+}
+
+uint KDisplayDaemon::requestProfile(const QString& name)
+{
+    auto const id = ++m_lastLayoutRequestId;
+    applyProfile(name, layoutRequest(id));
+    return id;
+}
+
+void KDisplayDaemon::applyProfile(QString const& name, ApplyScheduler::Done done)
+{
+    qCDebug(KDISPLAY_KDED) << "Applying profile:" << name;
+
+    auto const make = [this, name]() -> std::optional<Disman::ConfigPtr> {
+        // Taken as saved, without generating or checking it again.
+        auto config = m_monitoredConfig ? m_profileStore.layout(name, m_monitoredConfig) : nullptr;
+        if (!config) {
+            qCWarning(KDISPLAY_KDED) << "No profile" << name << "for the connected outputs";
+            return std::nullopt;
+        }
+        return config;
+    };
+    submitLayout(make, std::move(done));
+}
+
+ApplyScheduler::Done KDisplayDaemon::layoutRequest(uint id)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    return [this, id, timer](auto outcome) {
+        auto const success = outcome == ApplyScheduler::Outcome::Applied
+            || outcome == ApplyScheduler::Outcome::Unchanged
+            || outcome == ApplyScheduler::Outcome::Skipped;
+        auto const elapsed = outcome == ApplyScheduler::Outcome::Applied ? timer.elapsed() : 0;
+
+        // Queued so that the caller gets the id before the signal.
+        QMetaObject::invokeMethod(
+            this,
+            [this, id, success, elapsed] { Q_EMIT layoutApplied(id, success, elapsed); },
+            Qt::QueuedConnection);
+    };
 }
 
 bool KDisplayDaemon::getAutoRotate()
@@ -204,38 +529,267 @@ void KDisplayDaemon::setAutoRotate(bool value)
     if (!m_monitoredConfig || !m_orientationSensor->available()) {
         return;
     }
-    Config(m_monitoredConfig).setAutoRotate(value);
-    refreshConfig();
+    m_scheduler.submit(
+        ApplyScheduler::Priority::User, QStringLiteral("autoRotate"), [this, value] {
+            Config(m_monitoredConfig).setAutoRotate(value);
+            return m_monitoredConfig;
+        });
+}
+
+QVariantMap KDisplayDaemon::getStatistics()
+{
+    auto statistics = m_statistics.toVariantMap();
+    statistics.insert(QStringLiteral("queue"), m_scheduler.toVariantMap());
+    return statistics;
 }
 
-void KDisplayDaemon::applyOsdAction(KDisplay::OsdAction::Action action)
+void KDisplayDaemon::resetStatistics()
+{
+    m_statistics.reset();
+    m_scheduler.resetStatistics();
+}
+
+QString KDisplayDaemon::dumpFlightRecorder()
+{
+    return m_flightRecorder.dump();
+}
+
+void KDisplayDaemon::record(FlightRecorder::Event event, int32_t value)
+{
+    m_flightRecorder.record(event, m_activeFingerprint, m_connectedOutputCount, value);
+}
+
+void KDisplayDaemon::applyOsdAction(KDisplay::OsdAction::Action action, ApplyScheduler::Done done)
 {
     qCDebug(KDISPLAY_KDED) << "Applying OSD action:" << action;
 
-    if (auto config = Generator::displaySwitch(action, m_monitoredConfig)) {
-        doApplyConfig(config);
-    }
+    submitLayout([this, action] { return Generator::displaySwitch(action, m_monitoredConfig); },
+                 std::move(done));
+}
+
+void KDisplayDaemon::submitLayout(ApplyScheduler::Make make, ApplyScheduler::Done done)
+{
+    // A later layout request replaces this one when it has to wait.
+    m_scheduler.submit(ApplyScheduler::Priority::User,
+                       QStringLiteral("layout"),
+                       std::move(make),
+                       [this, done = std::move(done)](auto outcome) {
+                           // No apply to wait for, the hotplug is dealt with.
+                           if (outcome != ApplyScheduler::Outcome::Applied
+                               && outcome != ApplyScheduler::Outcome::Superseded) {
+                               endHotplugTrace();
+                           }
+                           if (done) {
+                               done(outcome);
+                           }
+                       });
 }
 
 void KDisplayDaemon::configChanged()
 {
     qCDebug(KDISPLAY_KDED) << "Change detected" << m_monitoredConfig;
-
+    Trace::instant("kded", "configChanged");
+    m_statistics.mark(Statistics::Event::ConfigChanged);
+    m_activeFingerprint = Fingerprint::config(m_monitoredConfig);
+
+    updateSummary();
+    record(FlightRecorder::Event::ConfigChanged);
+    updateSnapshot();
+    updateLidLayouts();
     update_auto_rotate();
     updateOrientation();
 }
 
+int KDisplayDaemon::connectedOutputCount() const
+{
+    return m_connectedOutputCount;
+}
+
+int KDisplayDaemon::enabledOutputCount() const
+{
+    return m_enabledOutputCount;
+}
+
+QString KDisplayDaemon::layout() const
+{
+    return QString::fromLatin1(
+        QMetaEnum::fromType<KDisplay::OsdAction::Action>().valueToKey(m_layout));
+}
+
+QStringList KDisplayDaemon::profiles() const
+{
+    return m_profiles;
+}
+
+static KDisplay::OsdAction::Action layoutOf(Disman::ConfigPtr const& config)
+{
+    using Action = KDisplay::OsdAction::Action;
+
+    std::vector<Disman::OutputPtr> enabled;
+    for (auto const& [id, output] : config->outputs()) {
+        if (output->enabled()) {
+            enabled.push_back(output);
+        }
+    }
+    if (enabled.empty()) {
+        return Action::NoAction;
+    }
+
+    auto const isPanel
+        = [](auto const& output) { return output->type() == Disman::Output::Type::Panel; };
+    if (enabled.size() == 1) {
+        return isPanel(enabled.front()) ? Action::SwitchToInternal : Action::SwitchToExternal;
+    }
+
+    auto const sources = std::count_if(enabled.cbegin(), enabled.cend(), [](auto const& output) {
+        return output->replication_source() == 0;
+    });
+    if (sources == 1) {
+        return Action::Clone;
+    }
+
+    auto const panel = std::find_if(enabled.cbegin(), enabled.cend(), isPanel);
+    if (sources != static_cast<std::ptrdiff_t>(enabled.size()) || panel == enabled.cend()) {
+        return Action::NoAction;
+    }
+
+    // Extended to the right when the panel is the leftmost output.
+    auto const leftmost
+        = std::min_element(enabled.cbegin(), enabled.cend(), [](auto const& lhs, auto const& rhs) {
+              return lhs->position().x() < rhs->position().x();
+          });
+    return (*leftmost)->position().x() < (*panel)->position().x() ? Action::ExtendLeft
+                                                                  : Action::ExtendRight;
+}
+
+void KDisplayDaemon::updateSummary()
+{
+    if (!m_monitoredConfig) {
+        return;
+    }
+
+    int const connected = m_monitoredConfig->outputs().size();
+    int enabled = 0;
+    for (auto const& [id, output] : m_monitoredConfig->outputs()) {
+        enabled += output->enabled();
+    }
+    auto const layout = layoutOf(m_monitoredConfig);
+    auto const profiles = m_profileStore.names(m_monitoredConfig);
+
+    QVariantMap changed;
+    if (connected != m_connectedOutputCount) {
+        m_connectedOutputCount = connected;
+        changed.insert(QStringLiteral("connectedOutputCount"), connected);
+        Q_EMIT connectedOutputCountChanged();
+    }
+    if (enabled != m_enabledOutputCount) {
+        m_enabledOutputCount = enabled;
+        changed.insert(QStringLiteral("enabledOutputCount"), enabled);
+        Q_EMIT enabledOutputCountChanged();
+    }
+    if (layout != m_layout) {
+        m_layout = layout;
+        changed.insert(QStringLiteral("layout"), this->layout());
+        Q_EMIT layoutChanged();
+    }
+    if (profiles != m_profiles) {
+        m_profiles = profiles;
+        changed.insert(QStringLiteral("profiles"), profiles);
+        Q_EMIT profilesChanged();
+    }
+    if (changed.isEmpty()) {
+        return;
+    }
+
+    auto signal = QDBusMessage::createSignal(QStringLiteral("/modules/kdisplay"),
+                                             QStringLiteral("org.freedesktop.DBus.Properties"),
+                                             QStringLiteral("PropertiesChanged"));
+    signal << QStringLiteral("org.kwinft.kdisplay") << changed << QStringList();
+    QDBusConnection::sessionBus().send(signal);
+}
+
+QDBusUnixFileDescriptor KDisplayDaemon::getSnapshot()
+{
+    if (!m_snapshotFd.isValid()) {
+        Trace::Span span("kded", "createSnapshot");
+        auto const fd = Snapshot::createSealedFd(
+            Snapshot::serialize(m_monitoredConfig, m_snapshotGeneration));
+        if (fd < 0) {
+            qCWarning(KDISPLAY_KDED) << "Failed to create config snapshot:" << strerror(errno);
+            return {};
+        }
+        m_snapshotFd.giveFileDescriptor(fd);
+    }
+    return m_snapshotFd;
+}
+
+void KDisplayDaemon::updateSnapshot()
+{
+    auto const fingerprint = Fingerprint::config(m_monitoredConfig);
+    if (m_snapshotGeneration && fingerprint == m_snapshotFingerprint) {
+        return;
+    }
+
+    m_snapshotGeneration++;
+    m_snapshotFingerprint = fingerprint;
+    m_snapshotFd = QDBusUnixFileDescriptor();
+    Q_EMIT snapshotChanged(m_snapshotGeneration);
+}
+
 void KDisplayDaemon::show_osd()
 {
-    auto call = m_osdServiceInterface->showActionSelector();
-    auto watcher = new QDBusPendingCallWatcher(call);
-    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher] {
+    // Tell the OSD where to show up so it doesn't need to fetch the config itself. It falls back
+    // to fetching when its screens don't match what we pass.
+    auto const output = m_monitoredConfig ? Utils::osdOutput(m_monitoredConfig) : nullptr;
+
+    // Sent first on every request since the OSD service may have timed out or restarted since the
+    // last one. Its reply picks from the list sent with that request, not from later ones.
+    auto const profiles = m_profiles;
+    m_osdServiceInterface->setProfiles(profiles);
+
+    QDBusPendingReply<int, int> call;
+    if (output) {
+        call = m_osdServiceInterface->showActionSelectorOn(QString::fromStdString(output->name()),
+                                                           output->geometry().toRect());
+    } else {
+        call = m_osdServiceInterface->showActionSelector();
+    }
+    m_statistics.mark(Statistics::Event::OsdRequested);
+    m_statistics.count(Statistics::Counter::OsdRequests);
+    record(FlightRecorder::Event::OsdRequested);
+
+    auto const traceId = ++m_traceId;
+    Trace::asyncBegin("kded", "osd", traceId);
+
+    auto watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher, traceId, profiles] {
         watcher->deleteLater();
-        QDBusReply<int> reply = *watcher;
-        if (!reply.isValid()) {
+        Trace::asyncEnd("kded", "osd", traceId);
+        m_statistics.mark(Statistics::Event::OsdReply);
+
+        QDBusPendingReply<int, int> reply = *watcher;
+        if (reply.isError()) {
+            record(FlightRecorder::Event::OsdReply, -1);
+            m_statistics.count(Statistics::Counter::OsdCancellations);
+            endHotplugTrace();
             return;
         }
-        applyOsdAction(static_cast<KDisplay::OsdAction::Action>(reply.value()));
+
+        auto const action = static_cast<KDisplay::OsdAction::Action>(reply.argumentAt<0>());
+        auto const profile = reply.argumentAt<1>();
+        record(FlightRecorder::Event::OsdReply, action);
+        if (profile >= 0) {
+            if (profile < profiles.size()) {
+                applyProfile(profiles.at(profile));
+            } else {
+                endHotplugTrace();
+            }
+            return;
+        }
+        if (action == KDisplay::OsdAction::NoAction) {
+            m_statistics.count(Statistics::Counter::OsdCancellations);
+        }
+        applyOsdAction(action);
     });
 }
 
@@ -8,14 +8,22 @@
 #define KSCREEN_DAEMON_H
 
 #include "../osd/osdaction.h"
+#include "apply_scheduler.h"
+#include "flight_recorder.h"
+#include "profiles.h"
+#include "refresh_policy.h"
+#include "statistics.h"
 
 #include <disman/config.h>
 
 #include <kdedmodule.h>
 
+#include <QDBusConnection>
+#include <QDBusUnixFileDescriptor>
 #include <QVariant>
 
 class OrgKwinftKdisplayOsdServiceInterface;
+class UPower;
 
 namespace Disman
 {
@@ -29,38 +37,185 @@ class KDisplayDaemon : public KDEDModule
     Q_OBJECT
     Q_CLASSINFO("D-Bus Interface", "org.kwinft.kdisplay")
 
+    /**
+     * A summary of the outputs for clients that don't need the whole config. Changes are also
+     * announced with PropertiesChanged on the bus.
+     */
+    Q_PROPERTY(int connectedOutputCount READ connectedOutputCount NOTIFY
+                   connectedOutputCountChanged)
+    Q_PROPERTY(int enabledOutputCount READ enabledOutputCount NOTIFY enabledOutputCountChanged)
+    /**
+     * The name of the OSD action the current layout corresponds to, NoAction when none does.
+     */
+    Q_PROPERTY(QString layout READ layout NOTIFY layoutChanged)
+    /**
+     * The names of the profiles saved for the connected outputs.
+     */
+    Q_PROPERTY(QStringList profiles READ profiles NOTIFY profilesChanged)
+
 public:
     KDisplayDaemon(QObject* parent, const QList<QVariant>&);
+    /**
+     * Follows @p orientationSensor, which it takes over, and UPower on @p systemBus. Unlike the
+     * plugin's daemon it does not register the global shortcut.
+     */
+    KDisplayDaemon(QObject* parent,
+                   OrientationSensor* orientationSensor,
+                   QDBusConnection const& systemBus);
+
+    int connectedOutputCount() const;
+    int enabledOutputCount() const;
+    QString layout() const;
+    QStringList profiles() const;
 
 public Q_SLOTS:
     // DBus
     void applyLayoutPreset(const QString& presetName);
+    /**
+     * Like applyLayoutPreset but returns an id that layoutApplied is emitted with once the
+     * layout is in place or could not be applied.
+     */
+    uint requestLayoutPreset(const QString& presetName);
+    /**
+     * Saves the current layout as a profile for the connected outputs, replacing one with the
+     * same name. Fails for layouts the backend can't apply.
+     */
+    bool saveProfile(const QString& name);
+    bool removeProfile(const QString& name);
+    /**
+     * Applies a profile of the connected outputs with a single apply. Returns an id like
+     * requestLayoutPreset.
+     */
+    uint requestProfile(const QString& name);
+    /**
+     * A sealed memfd with the current config in the format of common/snapshot.h. Created on
+     * demand and shared by all callers until the generation changes.
+     */
+    QDBusUnixFileDescriptor getSnapshot();
     bool getAutoRotate();
     void setAutoRotate(bool value);
+    QVariantMap getStatistics();
+    void resetStatistics();
+    QString dumpFlightRecorder();
+
+Q_SIGNALS:
+    void connectedOutputCountChanged();
+    void enabledOutputCountChanged();
+    void layoutChanged();
+    void profilesChanged();
+
+    /**
+     * Emitted for a request from requestLayoutPreset or requestProfile, always after it returned.
+     * A layout equal to the current one succeeds right away, one replaced by a later request
+     * before it was in place fails.
+     */
+    void layoutApplied(uint requestId, bool success, uint elapsedMs);
+
+    /**
+     * A snapshot of a different layout is available, clients re-read it on their next access.
+     */
+    void snapshotChanged(qulonglong generation);
+
+public:
+    // For tests and benchmarks.
+    Disman::ConfigPtr monitoredConfig() const
+    {
+        return m_monitoredConfig;
+    }
+    Statistics const& statistics() const
+    {
+        return m_statistics;
+    }
+    OrientationSensor* orientationSensor() const
+    {
+        return m_orientationSensor;
+    }
+    UPower* upower() const
+    {
+        return m_upower;
+    }
+    ApplyScheduler const& scheduler() const
+    {
+        return m_scheduler;
+    }
 
 private:
     void init(Disman::ConfigOperation* op);
 
+    void hotplug();
+    void endHotplugTrace();
     void applyConfig();
     void configChanged();
     void displayButton();
     void setMonitorForChanges(bool enabled);
 
     void show_osd();
-    void applyOsdAction(KDisplay::OsdAction::Action action);
 
-    void doApplyConfig(Disman::ConfigPtr const& config);
-    void refreshConfig();
+    void applyOsdAction(KDisplay::OsdAction::Action action, ApplyScheduler::Done done = {});
+    void applyProfile(QString const& name, ApplyScheduler::Done done = {});
+    void submitLayout(ApplyScheduler::Make make, ApplyScheduler::Done done);
+    /**
+     * Emits layoutApplied for request @p id once called with the outcome.
+     */
+    ApplyScheduler::Done layoutRequest(uint id);
+
+    /**
+     * Applies @p config unless it equals the active config. Returns whether an apply started.
+     * Only the scheduler calls this, everything else submits to it.
+     */
+    bool doApplyConfig(Disman::ConfigPtr const& config, uint64_t applyId);
+    void refreshConfig(uint64_t applyId);
 
     void update_auto_rotate();
     void updateOrientation();
+    void updateLidLayouts();
+    void lidClosedChanged(bool closed);
+    void followClosedLid();
+    void onBatteryChanged(bool onBattery);
+    void submitRefreshPolicy(bool onBattery);
+    void reconcileRefreshRates();
+    void updateSummary();
+    void updateSnapshot();
+    // With the fingerprint and output count as last updated.
+    void record(FlightRecorder::Event event, int32_t value = 0);
 
     Disman::ConfigPtr m_monitoredConfig;
+    // What the backend last reported or was last told to apply, 0 when unknown.
+    uint64_t m_activeFingerprint = 0;
     bool m_monitoring;
-    bool m_configDirty = true;
-    OrgKwinftKdisplayOsdServiceInterface* m_osdServiceInterface;
+    bool m_globalShortcut = false;
+    OrgKwinftKdisplayOsdServiceInterface* m_osdServiceInterface = nullptr;
     OrientationSensor* m_orientationSensor;
+    UPower* m_upower;
+    ApplyScheduler m_scheduler;
     bool m_startingUp = true;
+    Statistics m_statistics;
+    FlightRecorder m_flightRecorder;
+    uint64_t m_traceId = 0;
+    uint64_t m_hotplugTraceId = 0;
+
+    int m_connectedOutputCount = 0;
+    int m_enabledOutputCount = 0;
+    KDisplay::OsdAction::Action m_layout = KDisplay::OsdAction::NoAction;
+
+    // What to apply when the lid closes or opens, for the config with m_lidLayoutsFingerprint.
+    Disman::ConfigPtr m_lidClosedConfig;
+    Disman::ConfigPtr m_lidOpenedConfig;
+    uint64_t m_lidLayoutsFingerprint = 0;
+    // Restored when the lid opens again with the same outputs.
+    Disman::ConfigPtr m_layoutBeforeLidClosed;
+
+    RefreshPolicy m_refreshPolicy;
+
+    ProfileStore m_profileStore;
+    QStringList m_profiles;
+
+    uint m_lastLayoutRequestId = 0;
+    uint64_t m_lastPowerRequest = 0;
+
+    uint64_t m_snapshotGeneration = 0;
+    uint64_t m_snapshotFingerprint = 0;
+    QDBusUnixFileDescriptor m_snapshotFd;
 };
 
 #endif /*KSCREEN_DAEMON_H*/
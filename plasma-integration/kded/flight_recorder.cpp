@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "flight_recorder.h"
+
+#include <QDateTime>
+#include <QTextStream>
+
+#include <algorithm>
+#include <chrono>
+
+static constexpr std::array<char const*, 9> event_names{
+    "hotplug",
+    "configChanged",
+    "osdRequested",
+    "osdReply",
+    "orientation",
+    "lid",
+    "powerSource",
+    "applyStarted",
+    "applyFinished",
+};
+
+static int64_t now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void FlightRecorder::record(Event event, uint64_t fingerprint, int outputs, int32_t value)
+{
+    auto& record = m_records[m_count % capacity];
+    record.time = now();
+    record.fingerprint = fingerprint;
+    record.value = value;
+    record.outputs = static_cast<uint8_t>(std::clamp(outputs, 0, 255));
+    record.event = event;
+    m_count++;
+}
+
+QString FlightRecorder::dump() const
+{
+    QString text;
+    QTextStream stream(&text);
+
+    stream << "# monotonic " << static_cast<qlonglong>(now()) << " = "
+           << QDateTime::currentDateTime().toString(Qt::ISODateWithMs) << '\n';
+    stream << "# " << static_cast<qulonglong>(m_count) << " events recorded, showing the last "
+           << static_cast<qulonglong>(std::min<uint64_t>(m_count, capacity)) << '\n';
+
+    auto const first = m_count > capacity ? m_count - capacity : 0;
+    for (auto i = first; i < m_count; i++) {
+        auto const& record = m_records[i % capacity];
+        stream << static_cast<qlonglong>(record.time) << ' '
+               << event_names[static_cast<size_t>(record.event)] << ' ' << record.value << ' '
+               << static_cast<int>(record.outputs) << ' '
+               << QString::number(record.fingerprint, 16).rightJustified(16, QLatin1Char('0'))
+               << '\n';
+    }
+    stream.flush();
+    return text;
+}
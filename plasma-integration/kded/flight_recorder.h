@@ -0,0 +1,64 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QString>
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Keeps the last display events of the daemon in a fixed ring buffer, so they can be retrieved
+ * after the fact when something went wrong. Recording does not allocate and is cheap enough to
+ * stay always on.
+ */
+class FlightRecorder
+{
+public:
+    enum class Event : uint8_t {
+        Hotplug,
+        ConfigChanged,
+        OsdRequested,
+        // Value is the selected OsdAction::Action, which is NoAction also when a profile was
+        // selected, or -1 when the OSD did not reply.
+        OsdReply,
+        // Value is the QOrientationReading::Orientation.
+        Orientation,
+        // Value is 1 when the lid was closed and 0 when it was opened.
+        Lid,
+        // Value is 1 when running on battery and 0 on AC.
+        PowerSource,
+        ApplyStarted,
+        // Value is 1 on success and 0 on failure.
+        ApplyFinished,
+    };
+
+    struct Record {
+        int64_t time;
+        uint64_t fingerprint;
+        int32_t value;
+        uint8_t outputs;
+        Event event;
+    };
+
+    static constexpr size_t capacity = 256;
+
+    /**
+     * @p fingerprint and @p outputs describe the config at the time. They are passed in since
+     * the daemon tracks them anyway, computing them here would allocate.
+     */
+    void record(Event event, uint64_t fingerprint, int outputs, int32_t value = 0);
+
+    /**
+     * The recorded events from oldest to newest, one per line. Times are microseconds of the
+     * monotonic clock, the first line relates it to the wall clock.
+     */
+    QString dump() const;
+
+private:
+    std::array<Record, capacity> m_records{};
+    uint64_t m_count{0};
+};
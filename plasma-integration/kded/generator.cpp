@@ -6,7 +6,7 @@
 */
 #include "generator.h"
 
-#include "kdisplay_daemon_debug.h"
+#include "kdisplay_generator_debug.h"
 
 #include <disman/config.h>
 #include <disman/generator.h>
@@ -17,15 +17,16 @@ namespace Generator
 
 Disman::ConfigPtr displaySwitch(KDisplay::OsdAction::Action action, Disman::ConfigPtr const& config)
 {
-    qCDebug(KDISPLAY_KDED) << "Display Switch";
+    qCDebug(KDISPLAY_GENERATOR) << "Display Switch";
 
     auto const outputs_cnt = config->outputs().size();
     if (outputs_cnt < 2) {
-        qCDebug(KDISPLAY_KDED) << "Only one output connected. Display Switch not applicable.";
+        qCDebug(KDISPLAY_GENERATOR) << "Only one output connected. Display Switch not applicable.";
         return nullptr;
     }
     if (outputs_cnt > 2) {
-        qCDebug(KDISPLAY_KDED) << "More than two outputs connected. Display Switch not applicable.";
+        qCDebug(KDISPLAY_GENERATOR)
+            << "More than two outputs connected. Display Switch not applicable.";
         return nullptr;
     }
 
@@ -34,17 +35,17 @@ Disman::ConfigPtr displaySwitch(KDisplay::OsdAction::Action action, Disman::Conf
     auto success = false;
     switch (action) {
     case KDisplay::OsdAction::ExtendLeft: {
-        qCDebug(KDISPLAY_KDED) << "Extend to left";
+        qCDebug(KDISPLAY_GENERATOR) << "Extend to left";
         success = generator.extend(Disman::Generator::Extend_direction::left);
         break;
     }
     case KDisplay::OsdAction::ExtendRight: {
-        qCDebug(KDISPLAY_KDED) << "Extend to right";
+        qCDebug(KDISPLAY_GENERATOR) << "Extend to right";
         success = generator.extend(Disman::Generator::Extend_direction::right);
         break;
     }
     case KDisplay::OsdAction::SwitchToExternal: {
-        qCDebug(KDISPLAY_KDED) << "Turn off embedded (laptop)";
+        qCDebug(KDISPLAY_GENERATOR) << "Turn off embedded (laptop)";
         auto embedded = generator.embedded();
         if (embedded) {
             embedded->set_enabled(false);
@@ -53,9 +54,9 @@ Disman::ConfigPtr displaySwitch(KDisplay::OsdAction::Action action, Disman::Conf
         break;
     }
     case KDisplay::OsdAction::SwitchToInternal: {
-        qCDebug(KDISPLAY_KDED) << "Turn off external screen";
+        qCDebug(KDISPLAY_GENERATOR) << "Turn off external screen";
         // TODO: Why would a user want to do that?
-        qCWarning(KDISPLAY_KDED)
+        qCWarning(KDISPLAY_GENERATOR)
             << "Weird option to turn off external was selected, just do nothing instead.";
         break;
     }
@@ -74,4 +75,42 @@ Disman::ConfigPtr displaySwitch(KDisplay::OsdAction::Action action, Disman::Conf
     return generator.config();
 }
 
+Disman::ConfigPtr lidClosed(Disman::ConfigPtr const& config)
+{
+    if (config->outputs().size() < 2) {
+        return nullptr;
+    }
+
+    Disman::Generator generator(config);
+    auto embedded = generator.embedded();
+    if (!embedded || !embedded->enabled()) {
+        return nullptr;
+    }
+    embedded->set_enabled(false);
+    if (!generator.optimize()) {
+        return nullptr;
+    }
+    generator.config()->set_cause(Disman::Config::Cause::interactive);
+    return generator.config();
+}
+
+Disman::ConfigPtr lidOpened(Disman::ConfigPtr const& config)
+{
+    Disman::Generator generator(config);
+    auto embedded = generator.embedded();
+    if (!embedded || embedded->enabled()) {
+        return nullptr;
+    }
+    embedded->set_enabled(true);
+
+    auto const success = config->outputs().size() < 2
+        ? generator.optimize()
+        : generator.extend(Disman::Generator::Extend_direction::right);
+    if (!success) {
+        return nullptr;
+    }
+    generator.config()->set_cause(Disman::Config::Cause::interactive);
+    return generator.config();
+}
+
 }
@@ -16,4 +16,16 @@ namespace Generator
 Disman::ConfigPtr displaySwitch(KDisplay::OsdAction::Action action,
                                 Disman::ConfigPtr const& config);
 
+/**
+ * The layout for a closed lid: @p config with the laptop panel disabled and the other outputs
+ * arranged without it. Null when the panel is off already or the only output.
+ */
+Disman::ConfigPtr lidClosed(Disman::ConfigPtr const& config);
+
+/**
+ * The layout for an opened lid when there is no earlier one to go back to: @p config with the
+ * laptop panel enabled left of the other outputs. Null when the panel is on already.
+ */
+Disman::ConfigPtr lidOpened(Disman::ConfigPtr const& config);
+
 }
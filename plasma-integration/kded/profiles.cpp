@@ -0,0 +1,236 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "profiles.h"
+
+#include "../../common/fingerprint.h"
+#include "../../common/snapshot.h"
+#include "../../common/trace.h"
+#include "kdisplay_daemon_debug.h"
+
+#include <disman/config.h>
+#include <disman/mode.h>
+#include <disman/output.h>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+
+static constexpr quint32 s_magic = 0x4b445046; // "KDPF"
+static constexpr quint32 s_version = 1;
+
+ProfileStore::ProfileStore(QString path)
+    : m_path(std::move(path))
+{
+}
+
+QString ProfileStore::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
+        + QStringLiteral("/kdisplay/profiles");
+}
+
+void ProfileStore::load()
+{
+    Trace::Span span("kded", "ProfileStore::load");
+    m_profiles.clear();
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic;
+    quint32 version;
+    quint32 count;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != s_magic || version != s_version) {
+        qCWarning(KDISPLAY_KDED) << "Ignoring invalid profile store" << m_path;
+        return;
+    }
+
+    std::vector<Profile> profiles;
+    for (quint32 index = 0; index < count; index++) {
+        Profile profile;
+        quint64 setup;
+        stream >> profile.name >> setup >> profile.snapshot;
+        if (stream.status() != QDataStream::Ok) {
+            qCWarning(KDISPLAY_KDED) << "Ignoring truncated profile store" << m_path;
+            return;
+        }
+        profile.setup = setup;
+        profiles.push_back(std::move(profile));
+    }
+    m_profiles = std::move(profiles);
+}
+
+QStringList ProfileStore::names(Disman::ConfigPtr const& config) const
+{
+    auto const setup = Fingerprint::setup(config);
+
+    QStringList names;
+    for (auto const& profile : m_profiles) {
+        if (profile.setup == setup) {
+            names.append(profile.name);
+        }
+    }
+    names.sort();
+    return names;
+}
+
+bool ProfileStore::save(QString const& name, Disman::ConfigPtr const& config)
+{
+    if (name.isEmpty() || !config) {
+        return false;
+    }
+
+    auto const outputs = config->outputs();
+    auto const anyEnabled = std::any_of(outputs.cbegin(), outputs.cend(), [](auto const& entry) {
+        return entry.second->enabled();
+    });
+    if (!anyEnabled || !Disman::Config::can_be_applied(config)) {
+        qCDebug(KDISPLAY_KDED) << "Not saving profile" << name << "that can't be applied";
+        return false;
+    }
+
+    Profile profile{name, Fingerprint::setup(config), Snapshot::serialize(config, 0)};
+    auto const it = std::find_if(m_profiles.begin(), m_profiles.end(), [&](auto const& entry) {
+        return entry.name == name && entry.setup == profile.setup;
+    });
+    if (it == m_profiles.end()) {
+        m_profiles.push_back(std::move(profile));
+    } else {
+        *it = std::move(profile);
+    }
+    return write();
+}
+
+bool ProfileStore::remove(QString const& name, Disman::ConfigPtr const& config)
+{
+    auto const setup = Fingerprint::setup(config);
+    auto const it = std::find_if(m_profiles.begin(), m_profiles.end(), [&](auto const& entry) {
+        return entry.name == name && entry.setup == setup;
+    });
+    if (it == m_profiles.end()) {
+        return false;
+    }
+    m_profiles.erase(it);
+    return write();
+}
+
+Disman::ConfigPtr ProfileStore::layout(QString const& name, Disman::ConfigPtr const& current) const
+{
+    Trace::Span span("kded", "ProfileStore::layout");
+
+    auto const setup = Fingerprint::setup(current);
+    auto const it = std::find_if(m_profiles.cbegin(), m_profiles.cend(), [&](auto const& entry) {
+        return entry.name == name && entry.setup == setup;
+    });
+    if (it == m_profiles.cend()) {
+        return nullptr;
+    }
+
+    Snapshot::View const view(it->snapshot.constData(), it->snapshot.size());
+    if (!view.isValid()) {
+        qCWarning(KDISPLAY_KDED) << "Profile" << name << "is invalid";
+        return nullptr;
+    }
+
+    auto config = current->clone();
+
+    // Ids may have changed since the profile was saved, so outputs are matched by their hash.
+    std::map<int, Disman::OutputPtr> outputs;
+    std::set<int> taken;
+    for (int index = 0; index < view.outputCount(); index++) {
+        auto const& record = view.output(index);
+        auto const hash = view.string(record.hash);
+        for (auto const& [id, output] : config->outputs()) {
+            if (!taken.count(id) && output->hash() == hash) {
+                outputs.emplace(record.id, output);
+                taken.insert(id);
+                break;
+            }
+        }
+        if (!outputs.count(record.id)) {
+            return nullptr;
+        }
+    }
+
+    Disman::OutputPtr primary;
+    for (int index = 0; index < view.outputCount(); index++) {
+        auto const& record = view.output(index);
+        auto const& output = outputs.at(record.id);
+
+        if (record.modeWidth > 0) {
+            auto const modes = output->modes();
+            auto const mode = modes.find(std::string(view.string(record.modeId)));
+            if (mode == modes.end()) {
+                return nullptr;
+            }
+            output->set_mode(mode->second);
+        }
+
+        auto const source = outputs.find(record.replicationSource);
+        output->set_enabled(record.flags & Snapshot::Enabled);
+        output->set_position(QPointF(record.x, record.y));
+        output->set_scale(record.scale);
+        output->set_rotation(static_cast<Disman::Output::Rotation>(record.rotation));
+        output->set_replication_source(source == outputs.end() ? 0 : source->second->id());
+        output->set_retention(static_cast<Disman::Output::Retention>(record.retention));
+        output->set_adaptive_sync(record.flags & Snapshot::AdaptiveSync);
+        output->set_auto_resolution(record.flags & Snapshot::AutoResolution);
+        output->set_auto_refresh_rate(record.flags & Snapshot::AutoRefreshRate);
+        output->set_auto_rotate(record.flags & Snapshot::AutoRotate);
+        output->set_auto_rotate_only_in_tablet_mode(record.flags
+                                                    & Snapshot::AutoRotateOnlyInTabletMode);
+        if (record.flags & Snapshot::Primary) {
+            primary = output;
+        }
+    }
+
+    if (primary && (config->supported_features() & Disman::Config::Feature::PrimaryDisplay)) {
+        config->set_primary_output(primary);
+    }
+    config->set_cause(Disman::Config::Cause::interactive);
+
+    // The layout was checked when it was saved. That only holds when it came out the same.
+    if (Fingerprint::config(config) != view.fingerprint()
+        && !Disman::Config::can_be_applied(config)) {
+        qCDebug(KDISPLAY_KDED) << "Profile" << name << "can't be applied to the current outputs";
+        return nullptr;
+    }
+    return config;
+}
+
+bool ProfileStore::write() const
+{
+    Trace::Span span("kded", "ProfileStore::write");
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KDISPLAY_KDED) << "Failed to write profiles:" << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << s_magic << s_version << static_cast<quint32>(m_profiles.size());
+    for (auto const& profile : m_profiles) {
+        stream << profile.name << static_cast<quint64>(profile.setup) << profile.snapshot;
+    }
+    return file.commit();
+}
@@ -0,0 +1,67 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <disman/types.h>
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Named layouts the user saved, like "presentation" or "docked", kept in a single file.
+ *
+ * A profile belongs to the set of outputs it was saved for, identified by Fingerprint::setup,
+ * so the same name can stand for different layouts at different desks. Layouts are stored as
+ * config snapshots (common/snapshot.h) and only stored when Config::can_be_applied accepts
+ * them. Applying one then only has to copy its settings to the current outputs.
+ */
+class ProfileStore
+{
+public:
+    explicit ProfileStore(QString path = defaultPath());
+
+    static QString defaultPath();
+
+    /**
+     * Reads the profiles from disk, replacing the ones in memory. A missing or invalid file
+     * leaves no profiles.
+     */
+    void load();
+
+    /**
+     * The names of the profiles saved for the outputs of @p config, sorted.
+     */
+    QStringList names(Disman::ConfigPtr const& config) const;
+
+    /**
+     * Saves the layout of @p config as @p name for its outputs and writes the store. Returns
+     * false when the layout can't be applied or the store could not be written.
+     */
+    bool save(QString const& name, Disman::ConfigPtr const& config);
+    bool remove(QString const& name, Disman::ConfigPtr const& config);
+
+    /**
+     * A copy of @p current with the layout of the profile @p name, ready to be applied. Null
+     * when there is no such profile for the outputs of @p current.
+     */
+    Disman::ConfigPtr layout(QString const& name, Disman::ConfigPtr const& current) const;
+
+private:
+    struct Profile {
+        QString name;
+        uint64_t setup;
+        QByteArray snapshot;
+    };
+
+    bool write() const;
+
+    QString m_path;
+    std::vector<Profile> m_profiles;
+};
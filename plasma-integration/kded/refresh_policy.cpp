@@ -0,0 +1,174 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "refresh_policy.h"
+
+#include "kdisplay_daemon_debug.h"
+
+#include <disman/config.h>
+#include <disman/mode.h>
+#include <disman/output.h>
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <algorithm>
+#include <optional>
+
+static KConfigGroup powerGroup()
+{
+    return KSharedConfig::openConfig(QStringLiteral("kdisplayrc"))->group(QStringLiteral("Power"));
+}
+
+RefreshPolicy::RefreshPolicy(int floor)
+    : m_floor(floor)
+{
+    load();
+}
+
+int RefreshPolicy::configuredFloor()
+{
+    return powerGroup().readEntry("BatteryRefreshFloor", 60) * 1000;
+}
+
+bool RefreshPolicy::lowered() const
+{
+    return !m_changes.empty();
+}
+
+void RefreshPolicy::commit()
+{
+    if (!m_pending) {
+        return;
+    }
+    auto const write = !m_changes.empty() || !m_pending->empty();
+    m_changes = std::move(*m_pending);
+    m_pending.reset();
+    if (write) {
+        save();
+    }
+}
+
+void RefreshPolicy::load()
+{
+    // Entries are the rate and the output hash, separated by the first colon.
+    auto const entries = powerGroup().readEntry("LoweredOutputs", QStringList());
+    for (auto const& entry : entries) {
+        auto const separator = entry.indexOf(QLatin1Char(':'));
+        bool ok = false;
+        auto const refresh = entry.left(separator).toInt(&ok);
+        if (separator < 0 || !ok) {
+            continue;
+        }
+        m_changes.push_back({entry.mid(separator + 1).toStdString(), refresh});
+    }
+}
+
+void RefreshPolicy::save() const
+{
+    QStringList entries;
+    for (auto const& change : m_changes) {
+        entries.append(QString::number(change.refresh) + QLatin1Char(':')
+                       + QString::fromStdString(change.hash));
+    }
+
+    auto group = powerGroup();
+    if (entries.isEmpty()) {
+        group.deleteEntry("LoweredOutputs");
+    } else {
+        group.writeEntry("LoweredOutputs", entries);
+    }
+    group.sync();
+}
+
+/**
+ * The lowest rate of the current resolution of @p output that is at least @p floor, when it is
+ * below the current rate.
+ */
+static std::optional<int> lowerRate(Disman::OutputPtr const& output, int floor)
+{
+    auto const current = output->auto_mode();
+    if (!current) {
+        return {};
+    }
+
+    std::optional<int> lowest;
+    for (auto const& [id, mode] : output->modes()) {
+        // Rates like 59.94 Hz count as 60 Hz.
+        if (mode->size() != current->size() || mode->refresh() + 500 < floor) {
+            continue;
+        }
+        if (!lowest || mode->refresh() < *lowest) {
+            lowest = mode->refresh();
+        }
+    }
+    if (!lowest || *lowest >= current->refresh()) {
+        return {};
+    }
+    return lowest;
+}
+
+bool RefreshPolicy::lower(Disman::ConfigPtr const& config)
+{
+    auto const adaptiveSync
+        = config->supported_features().testFlag(Disman::Config::Feature::AdaptiveSync);
+
+    auto changes = m_changes;
+    auto changed = false;
+    for (auto const& [id, output] : config->outputs()) {
+        if (!output->enabled() || !output->auto_refresh_rate()) {
+            continue;
+        }
+        auto const hash = output->hash();
+        if (std::any_of(changes.cbegin(), changes.cend(), [&](auto const& change) {
+                return change.hash == hash;
+            })) {
+            continue;
+        }
+
+        if (auto const rate = lowerRate(output, m_floor)) {
+            qCDebug(KDISPLAY_KDED) << "Lowering the refresh rate of" << output->name().c_str()
+                                   << "to" << *rate << "mHz on battery";
+            output->set_auto_refresh_rate(false);
+            output->set_refresh_rate(*rate);
+            changes.push_back({hash, *rate});
+            changed = true;
+        } else if (adaptiveSync && output->adaptive_sync_toggle_support()
+                   && !output->adaptive_sync()) {
+            qCDebug(KDISPLAY_KDED) << "Enabling adaptive sync of" << output->name().c_str()
+                                   << "on battery";
+            output->set_adaptive_sync(true);
+            changes.push_back({hash, 0});
+            changed = true;
+        }
+    }
+    m_pending = std::move(changes);
+    return changed;
+}
+
+bool RefreshPolicy::restore(Disman::ConfigPtr const& config)
+{
+    auto changed = false;
+    for (auto const& change : m_changes) {
+        for (auto const& [id, output] : config->outputs()) {
+            if (output->hash() != change.hash) {
+                continue;
+            }
+            if (change.refresh == 0) {
+                if (output->adaptive_sync()) {
+                    output->set_adaptive_sync(false);
+                    changed = true;
+                }
+            } else if (!output->auto_refresh_rate() && output->auto_mode()
+                       && output->auto_mode()->refresh() == change.refresh) {
+                output->set_auto_refresh_rate(true);
+                changed = true;
+            }
+            break;
+        }
+    }
+    m_pending.emplace();
+    return changed;
+}
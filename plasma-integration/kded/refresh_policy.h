@@ -0,0 +1,71 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <disman/types.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Lowers the refresh rate of outputs while running on battery and puts it back on AC.
+ *
+ * Only outputs that pick their refresh rate automatically are touched. They get the lowest rate
+ * of their resolution that is still at least the floor. Outputs without such a lower rate get
+ * adaptive sync instead, where the backend can toggle it. Whatever the user changed in between
+ * is left alone when restoring.
+ *
+ * What was changed is kept in the Power group of kdisplayrc, so it can still be restored after
+ * the daemon ended while on battery. Changes only count once committed, after they were applied.
+ */
+class RefreshPolicy
+{
+public:
+    /**
+     * @p floor is in mHz like Disman's refresh rates.
+     */
+    explicit RefreshPolicy(int floor = configuredFloor());
+
+    /**
+     * The floor from BatteryRefreshFloor in the Power group of kdisplayrc, 60 Hz by default.
+     */
+    static int configuredFloor();
+
+    /**
+     * Adjusts @p config for running on battery. Returns whether anything changed.
+     */
+    bool lower(Disman::ConfigPtr const& config);
+
+    /**
+     * Undoes on @p config what lower() changed. Returns whether anything changed.
+     */
+    bool restore(Disman::ConfigPtr const& config);
+
+    /**
+     * Takes what the last lower() or restore() did as the new state, once its config was applied.
+     */
+    void commit();
+
+    /**
+     * Whether there is something to restore.
+     */
+    bool lowered() const;
+
+private:
+    void load();
+    void save() const;
+
+    struct Change {
+        std::string hash;
+        // The rate that was set, 0 when adaptive sync was enabled instead.
+        int refresh;
+    };
+
+    int m_floor;
+    std::vector<Change> m_changes;
+    std::optional<std::vector<Change>> m_pending;
+};
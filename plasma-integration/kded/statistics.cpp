@@ -0,0 +1,155 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "statistics.h"
+
+#include <QVariantList>
+
+#include <algorithm>
+
+using namespace std::chrono;
+
+const std::array<Statistics::Stage, Statistics::stage_count> Statistics::stages{{
+    {"hotplugToDecision", Event::Hotplug, Event::Decision},
+    {"hotplugToApply", Event::Hotplug, Event::Apply},
+    {"hotplugToApplied", Event::Hotplug, Event::ApplyFinished},
+    {"osdRequestToReply", Event::OsdRequested, Event::OsdReply},
+    {"applyToApplied", Event::Apply, Event::ApplyFinished},
+    {"appliedToChanged", Event::ApplyFinished, Event::ConfigChanged},
+}};
+
+static constexpr std::array<char const*, 7> event_names{
+    "hotplug",
+    "decision",
+    "osdRequested",
+    "osdReply",
+    "apply",
+    "applyFinished",
+    "configChanged",
+};
+
+static constexpr std::array<char const*, 11> counter_names{
+    "hotplugs",
+    "applies",
+    "reapplies",
+    "orientationApplies",
+    "lidApplies",
+    "powerApplies",
+    "finishedApplies",
+    "failedApplies",
+    "osdRequests",
+    "osdCancellations",
+    "skippedApplies",
+};
+
+Statistics::Statistics()
+    : m_start{Clock::now()}
+{
+    static_assert(event_names.size() == event_count);
+    static_assert(counter_names.size() == counter_count);
+}
+
+void Statistics::Histogram::add(int64_t usecs)
+{
+    min = count ? std::min(min, usecs) : usecs;
+    max = count ? std::max(max, usecs) : usecs;
+    sum += usecs;
+    count++;
+
+    auto const msecs = usecs / 1000;
+    auto const bound = std::find_if(bucket_bounds.cbegin(),
+                                    bucket_bounds.cend(),
+                                    [msecs](auto bound) { return msecs < bound; });
+    buckets[std::distance(bucket_bounds.cbegin(), bound)]++;
+}
+
+void Statistics::mark(Event event)
+{
+    mark(event, Clock::now());
+}
+
+void Statistics::mark(Event event, Clock::time_point time)
+{
+    auto const index = static_cast<size_t>(event);
+    m_last[index] = time;
+    m_seen[index] = true;
+
+    for (size_t i = 0; i < stages.size(); i++) {
+        auto const& stage = stages[i];
+        if (stage.to != event) {
+            continue;
+        }
+
+        // Only the first end event after a start event counts, e.g. the first apply after a
+        // hotplug and not the re-applies following it.
+        auto const from = static_cast<size_t>(stage.from);
+        if (!m_seen[from] || m_last[from] <= m_stageEnd[i]) {
+            continue;
+        }
+        m_histograms[i].add(duration_cast<microseconds>(time - m_last[from]).count());
+        m_stageEnd[i] = time;
+    }
+}
+
+void Statistics::count(Counter counter)
+{
+    m_counters[static_cast<size_t>(counter)]++;
+}
+
+QVariantMap Statistics::toVariantMap() const
+{
+    QVariantList bounds;
+    for (auto bound : bucket_bounds) {
+        bounds << static_cast<qlonglong>(bound) * 1000;
+    }
+
+    QVariantMap stageMap;
+    for (size_t i = 0; i < stages.size(); i++) {
+        auto const& histogram = m_histograms[i];
+
+        QVariantList buckets;
+        for (auto bucket : histogram.buckets) {
+            buckets << static_cast<qulonglong>(bucket);
+        }
+
+        stageMap.insert(QString::fromLatin1(stages[i].name),
+                        QVariantMap{
+                            {QStringLiteral("count"), static_cast<qulonglong>(histogram.count)},
+                            {QStringLiteral("sum"), static_cast<qlonglong>(histogram.sum)},
+                            {QStringLiteral("min"), static_cast<qlonglong>(histogram.min)},
+                            {QStringLiteral("max"), static_cast<qlonglong>(histogram.max)},
+                            {QStringLiteral("buckets"), buckets},
+                        });
+    }
+
+    QVariantMap counterMap;
+    for (size_t i = 0; i < counter_count; i++) {
+        counterMap.insert(QString::fromLatin1(counter_names[i]),
+                          static_cast<qulonglong>(m_counters[i]));
+    }
+
+    QVariantMap eventMap;
+    for (size_t i = 0; i < event_count; i++) {
+        if (m_seen[i]) {
+            eventMap.insert(
+                QString::fromLatin1(event_names[i]),
+                static_cast<qlonglong>(duration_cast<microseconds>(m_last[i] - m_start).count()));
+        }
+    }
+
+    return {
+        {QStringLiteral("uptime"),
+         static_cast<qlonglong>(duration_cast<microseconds>(Clock::now() - m_start).count())},
+        {QStringLiteral("bucketBounds"), bounds},
+        {QStringLiteral("stages"), stageMap},
+        {QStringLiteral("counters"), counterMap},
+        {QStringLiteral("lastEvents"), eventMap},
+    };
+}
+
+void Statistics::reset()
+{
+    *this = Statistics();
+}
@@ -0,0 +1,95 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QVariantMap>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Latency and event bookkeeping of the daemon. Events are stamped with a monotonic clock, the
+ * time between related events is collected into per-stage histograms.
+ */
+class Statistics
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Event {
+        Hotplug,
+        Decision,
+        // The selector was requested from the OSD service and its answer arrived. The request is
+        // stamped when it is sent, the OSD may show up some time later.
+        OsdRequested,
+        OsdReply,
+        Apply,
+        ApplyFinished,
+        ConfigChanged,
+    };
+
+    enum class Counter {
+        Hotplugs,
+        Applies,
+        Reapplies,
+        OrientationApplies,
+        LidApplies,
+        PowerApplies,
+        FinishedApplies,
+        FailedApplies,
+        OsdRequests,
+        OsdCancellations,
+        // Applies not done since the config equaled the active one.
+        SkippedApplies,
+    };
+
+    Statistics();
+
+    void mark(Event event);
+    void mark(Event event, Clock::time_point time);
+    void count(Counter counter);
+
+    /**
+     * All stages, counters and last event times. Durations and times are in microseconds, times
+     * relative to the creation or last reset of the statistics.
+     */
+    QVariantMap toVariantMap() const;
+    void reset();
+
+private:
+    static constexpr size_t event_count = static_cast<size_t>(Event::ConfigChanged) + 1;
+    static constexpr size_t counter_count = static_cast<size_t>(Counter::SkippedApplies) + 1;
+    static constexpr size_t stage_count = 6;
+
+    // Upper bounds of the histogram buckets in milliseconds. One more bucket takes the rest.
+    static constexpr std::array<int, 12> bucket_bounds{1, 2, 5, 10, 20, 50, 100, 200, 500,
+                                                       1000, 2000, 5000};
+
+    struct Stage {
+        char const* name;
+        Event from;
+        Event to;
+    };
+    static const std::array<Stage, stage_count> stages;
+
+    struct Histogram {
+        uint64_t count{0};
+        int64_t sum{0};
+        int64_t min{0};
+        int64_t max{0};
+        std::array<uint64_t, bucket_bounds.size() + 1> buckets{};
+
+        void add(int64_t usecs);
+    };
+
+    Clock::time_point m_start;
+    std::array<Clock::time_point, event_count> m_last{};
+    std::array<bool, event_count> m_seen{};
+    std::array<Histogram, stage_count> m_histograms;
+    std::array<Clock::time_point, stage_count> m_stageEnd{};
+    std::array<uint64_t, counter_count> m_counters{};
+};
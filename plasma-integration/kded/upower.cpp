@@ -0,0 +1,99 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "upower.h"
+
+#include "freedesktop_interface.h"
+#include "kdisplay_daemon_debug.h"
+
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+
+static QString const s_service = QStringLiteral("org.freedesktop.UPower");
+static QString const s_path = QStringLiteral("/org/freedesktop/UPower");
+static QString const s_interface = QStringLiteral("org.freedesktop.UPower");
+
+UPower::UPower(QDBusConnection const& bus, QObject* parent)
+    : QObject(parent)
+    , m_properties(new OrgFreedesktopDBusPropertiesInterface(s_service, s_path, bus, this))
+{
+    connect(m_properties,
+            &OrgFreedesktopDBusPropertiesInterface::PropertiesChanged,
+            this,
+            [this](QString const& interface, QVariantMap const& changed) {
+                if (interface == s_interface) {
+                    update(changed);
+                }
+            });
+
+    auto watcher
+        = new QDBusServiceWatcher(s_service, bus, QDBusServiceWatcher::WatchForRegistration, this);
+    connect(watcher, &QDBusServiceWatcher::serviceRegistered, this, &UPower::fetch);
+
+    fetch();
+}
+
+UPower::~UPower() = default;
+
+bool UPower::isReady() const
+{
+    return m_ready;
+}
+
+bool UPower::lidPresent() const
+{
+    return m_lidPresent;
+}
+
+bool UPower::lidClosed() const
+{
+    return m_lidClosed;
+}
+
+bool UPower::onBattery() const
+{
+    return m_onBattery;
+}
+
+void UPower::fetch()
+{
+    auto watcher = new QDBusPendingCallWatcher(m_properties->GetAll(s_interface), this);
+    connect(watcher,
+            &QDBusPendingCallWatcher::finished,
+            this,
+            [this](QDBusPendingCallWatcher* watcher) {
+                watcher->deleteLater();
+                QDBusPendingReply<QVariantMap> reply = *watcher;
+                if (reply.isError()) {
+                    qCDebug(KDISPLAY_KDED) << "UPower not available:" << reply.error().message();
+                    return;
+                }
+                update(reply.value());
+                m_ready = true;
+                Q_EMIT ready();
+            });
+}
+
+void UPower::update(QVariantMap const& properties)
+{
+    auto it = properties.constFind(QStringLiteral("LidIsPresent"));
+    if (it != properties.constEnd() && it->toBool() != m_lidPresent) {
+        m_lidPresent = it->toBool();
+        Q_EMIT lidPresentChanged(m_lidPresent);
+    }
+
+    it = properties.constFind(QStringLiteral("LidIsClosed"));
+    if (it != properties.constEnd() && it->toBool() != m_lidClosed) {
+        m_lidClosed = it->toBool();
+        Q_EMIT lidClosedChanged(m_lidClosed);
+    }
+
+    it = properties.constFind(QStringLiteral("OnBattery"));
+    if (it != properties.constEnd() && it->toBool() != m_onBattery) {
+        m_onBattery = it->toBool();
+        Q_EMIT onBatteryChanged(m_onBattery);
+    }
+}
@@ -0,0 +1,54 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QDBusConnection>
+#include <QObject>
+#include <QVariantMap>
+
+class OrgFreedesktopDBusPropertiesInterface;
+
+/**
+ * Follows the state UPower publishes for the device as a whole. Starts out with no lid until
+ * UPower answered, and keeps following when the service is restarted.
+ *
+ * The daemon watches the system bus, tests put a stand-in on the session bus.
+ */
+class UPower : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UPower(QDBusConnection const& bus, QObject* parent = nullptr);
+    ~UPower() override;
+
+    /**
+     * Whether UPower answered, before that the state is only assumed.
+     */
+    bool isReady() const;
+    bool lidPresent() const;
+    bool lidClosed() const;
+    bool onBattery() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted whenever UPower answered with its full state, after the changed signals.
+     */
+    void ready();
+    void lidPresentChanged(bool present);
+    void lidClosedChanged(bool closed);
+    void onBatteryChanged(bool onBattery);
+
+private:
+    void fetch();
+    void update(QVariantMap const& properties);
+
+    OrgFreedesktopDBusPropertiesInterface* m_properties;
+    bool m_ready = false;
+    bool m_lidPresent = false;
+    bool m_lidClosed = false;
+    bool m_onBattery = false;
+};
@@ -12,7 +12,8 @@
 
 int main(int argc, char** argv)
 {
-    KDisplay::OsdManager osdManager;
     LayerShellQt::Shell::useLayerShell();
-    return QGuiApplication(argc, argv).exec();
+    QGuiApplication app(argc, argv);
+    KDisplay::OsdManager osdManager;
+    return app.exec();
 }
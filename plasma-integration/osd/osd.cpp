@@ -5,6 +5,7 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "osd.h"
+#include "../../common/trace.h"
 
 #include <KWindowSystem>
 #include <KX11Extras>
@@ -16,45 +17,64 @@
 #include <QScreen>
 #include <QStandardPaths>
 #include <QTimer>
-#include <disman/mode.h>
 
 using namespace KDisplay;
 
-Osd::Osd(Disman::OutputPtr const& output, QObject* parent)
+Osd::Osd(QQmlEngine* engine, QObject* parent)
     : QObject(parent)
-    , m_output(output)
+    , m_engine(engine)
 {
-    connect(output.get(), &Disman::Output::updated, this, &Osd::onOutputAvailabilityChanged);
-    m_engine.setProperty("_kirigamiTheme", QStringLiteral("KirigamiPlasmaStyle"));
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, &Osd::onScreenRemoved);
 }
 
 Osd::~Osd()
 {
 }
 
-void Osd::showActionSelector()
+bool Osd::prepare()
 {
-    if (!m_osdActionSelector) {
-        m_osdActionSelector = std::make_unique<QQuickView>(&m_engine, nullptr);
-        m_osdActionSelector->setInitialProperties(
-            {{QLatin1String("actions"), QVariant::fromValue(OsdAction::availableActions())}});
-        m_osdActionSelector->setSource(QUrl(QStringLiteral("qrc:/qml/OsdSelector.qml")));
-        m_osdActionSelector->setColor(Qt::transparent);
-        m_osdActionSelector->setFlag(Qt::FramelessWindowHint);
+    if (m_osdActionSelector) {
+        return true;
+    }
 
-        if (m_osdActionSelector->status() != QQuickView::Ready) {
-            qWarning() << "Failed to load OSD QML file";
-            m_osdActionSelector.reset();
-            return;
-        }
+    Trace::Span span("osd", "prepare");
+    m_osdActionSelector = std::make_unique<QQuickView>(m_engine, nullptr);
+    m_osdActionSelector->setInitialProperties(
+        {{QLatin1String("actions"),
+          QVariant::fromValue(OsdAction::availableActions(m_profiles))}});
+    m_osdActionSelector->setSource(
+        QUrl(QStringLiteral("qrc:/qt/qml/org/kwinft/kdisplay/OsdSelector.qml")));
+    m_osdActionSelector->setColor(Qt::transparent);
+    m_osdActionSelector->setFlag(Qt::FramelessWindowHint);
 
-        auto rootObject = m_osdActionSelector->rootObject();
-        connect(rootObject, SIGNAL(clicked(int)), this, SLOT(onOsdActionSelected(int)));
+    if (m_osdActionSelector->status() != QQuickView::Ready) {
+        qWarning() << "Failed to load OSD QML file";
+        m_osdActionSelector.reset();
+        return false;
     }
 
-    auto screen = qGuiApp->screenAt(m_output->position().toPoint());
-    if (!screen) {
-        screen = qGuiApp->primaryScreen();
+    auto rootObject = m_osdActionSelector->rootObject();
+    connect(rootObject, SIGNAL(clicked(int, int)), this, SLOT(onOsdActionSelected(int, int)));
+    return true;
+}
+
+void Osd::setProfiles(QStringList const& profiles)
+{
+    if (profiles == m_profiles) {
+        return;
+    }
+    m_profiles = profiles;
+    if (m_osdActionSelector) {
+        m_osdActionSelector->rootObject()->setProperty(
+            "actions", QVariant::fromValue(OsdAction::availableActions(m_profiles)));
+    }
+}
+
+void Osd::showActionSelector(QScreen* screen)
+{
+    Trace::Span span("osd", "showActionSelector");
+    if (!prepare()) {
+        return;
     }
 
     if (KWindowSystem::isPlatformWayland()) {
@@ -72,24 +92,33 @@ void Osd::showActionSelector()
         KX11Extras::setType(m_osdActionSelector->winId(), NET::OnScreenDisplay);
         m_osdActionSelector->requestActivate();
     }
+    // Repeated requests before a frame got swapped must not pile up connections.
+    disconnect(m_shownConnection);
+    m_shownConnection = connect(m_osdActionSelector.get(),
+                                &QQuickWindow::frameSwapped,
+                                this,
+                                &Osd::osdShown,
+                                Qt::SingleShotConnection);
     m_osdActionSelector->setVisible(true);
 }
 
-void Osd::onOsdActionSelected(int action)
+void Osd::onOsdActionSelected(int action, int profile)
 {
-    Q_EMIT osdActionSelected(static_cast<OsdAction::Action>(action));
+    Trace::instant("osd", "actionSelected");
+    Q_EMIT osdActionSelected(static_cast<OsdAction::Action>(action), profile);
     hideOsd();
 }
 
-void Osd::onOutputAvailabilityChanged()
+void Osd::onScreenRemoved(QScreen* screen)
 {
-    if (!m_output || !m_output->enabled() || !m_output->commanded_mode()) {
+    if (m_osdActionSelector && m_osdActionSelector->screen() == screen) {
         hideOsd();
     }
 }
 
 void Osd::hideOsd()
 {
+    Trace::instant("osd", "hideOsd");
     if (m_osdActionSelector) {
         m_osdActionSelector->setVisible(false);
     }
@@ -12,11 +12,12 @@
 #include <QQmlEngine>
 #include <QRect>
 #include <QString>
-#include <disman/output.h>
+#include <QStringList>
 #include <memory>
 
-class QTimer;
 class QQuickView;
+class QScreen;
+class QTimer;
 
 namespace KDisplay
 {
@@ -25,25 +26,39 @@ class Osd : public QObject
     Q_OBJECT
 
 public:
-    explicit Osd(Disman::OutputPtr const& output, QObject* parent = nullptr);
+    explicit Osd(QQmlEngine* engine, QObject* parent = nullptr);
     ~Osd() override;
 
-    void showActionSelector();
+    /**
+     * Creates the selector view without showing it, so a later call to showActionSelector
+     * becomes cheap.
+     */
+    bool prepare();
+    /**
+     * Offers these profiles in the selector besides the actions.
+     */
+    void setProfiles(QStringList const& profiles);
+    void showActionSelector(QScreen* screen);
     void hideOsd();
 
 Q_SIGNALS:
-    void osdActionSelected(OsdAction::Action action);
+    /**
+     * @p profile is the index of the selected profile or -1 when an action was selected.
+     */
+    void osdActionSelected(OsdAction::Action action, int profile);
+    void osdShown();
 
 private Q_SLOTS:
-    void onOsdActionSelected(int action);
-    void onOutputAvailabilityChanged();
+    void onOsdActionSelected(int action, int profile);
+    void onScreenRemoved(QScreen* screen);
 
 private:
-    Disman::OutputPtr m_output;
-    QQmlEngine m_engine;
+    QQmlEngine* m_engine;
     std::unique_ptr<QQuickView> m_osdActionSelector;
+    QMetaObject::Connection m_shownConnection;
     QTimer* m_osdTimer = nullptr;
     int m_timeout = 0;
+    QStringList m_profiles;
 };
 
 } // ns
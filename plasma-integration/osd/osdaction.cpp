@@ -32,3 +32,16 @@ QVector<OsdAction> OsdAction::availableActions()
         {NoAction, i18nd("kdisplay_common", "Leave unchanged"), QStringLiteral("dialog-cancel")},
     };
 }
+
+QVector<OsdAction> OsdAction::availableActions(QStringList const& profiles)
+{
+    auto actions = availableActions();
+    Q_ASSERT(actions.constLast().action == NoAction);
+
+    auto const end = actions.size() - 1;
+    for (int index = 0; index < profiles.size(); index++) {
+        actions.insert(end + index,
+                       {NoAction, profiles.at(index), QStringLiteral("video-display"), index});
+    }
+    return actions;
+}
@@ -13,6 +13,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
 namespace KDisplay
@@ -23,6 +24,7 @@ struct OsdAction {
     Q_PROPERTY(QString label MEMBER label CONSTANT)
     Q_PROPERTY(QString iconName MEMBER iconName CONSTANT)
     Q_PROPERTY(Action action MEMBER action CONSTANT)
+    Q_PROPERTY(int profile MEMBER profile CONSTANT)
 public:
     enum Action {
         NoAction,
@@ -37,8 +39,15 @@ public:
     Action action;
     QString label;
     QString iconName;
+    // For entries that pick a profile the index in the list the daemon last passed to the OSD
+    // service, with NoAction as action. Otherwise -1.
+    int profile = -1;
 
     static QVector<OsdAction> availableActions();
+    /**
+     * The available actions with one entry per profile before the one leaving things unchanged.
+     */
+    static QVector<OsdAction> availableActions(QStringList const& profiles);
 };
 
 }
@@ -0,0 +1,26 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "osdaction.h"
+
+#include <QQmlEngine>
+
+namespace KDisplay
+{
+
+/**
+ * Static QML declaration of OsdAction. It lives separately so the action type itself can be
+ * used from targets that do not link against QtQml.
+ */
+struct OsdActionForeign {
+    Q_GADGET
+    QML_FOREIGN(KDisplay::OsdAction)
+    QML_NAMED_ELEMENT(OsdAction)
+    QML_UNCREATABLE("Can't create OsdAction")
+};
+
+}
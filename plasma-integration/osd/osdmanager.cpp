@@ -5,131 +5,223 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "osdmanager.h"
+#include "../../common/snapshot_client.h"
+#include "../../common/trace.h"
+#include "../../common/utils.h"
+#include "kdisplay_osd_debug.h"
 #include "osd.h"
 #include "osdserviceadaptor.h"
 
+#include <KConfigGroup>
+#include <KSharedConfig>
 #include <QDBusConnection>
-#include <QDBusMessage>
-#include <QQmlEngine>
+#include <QGuiApplication>
+#include <QScreen>
 #include <disman/config.h>
 #include <disman/getconfigoperation.h>
 #include <disman/output.h>
 
 namespace KDisplay
 {
+
 OsdManager::OsdManager(QObject* parent)
     : QObject(parent)
+    , m_osd(new Osd(&m_engine, this))
     , m_cleanupTimer(new QTimer(this))
+    , m_snapshot(new SnapshotClient(this))
 {
-    qmlRegisterUncreatableType<KDisplay::OsdAction>(
-        "org.kwinft.kdisplay", 1, 0, "OsdAction", QStringLiteral("Can't create OsdAction"));
     new OsdServiceAdaptor(this);
-
-    // free up memory when the osd hasn't been used for more than 1 minute
-    m_cleanupTimer->setInterval(60000);
+    m_engine.setProperty("_kirigamiTheme", QStringLiteral("KirigamiPlasmaStyle"));
+
+    connect(m_osd, &Osd::osdActionSelected, this, [this](OsdAction::Action action, int profile) {
+        reply(action, profile);
+        hideOsd();
+    });
+    connect(m_osd, &Osd::osdShown, this, [this] {
+        Trace::instant("osd", "osdVisible");
+        qCDebug(KDISPLAY_OSD) << "Osd visible after" << m_requestTimer.elapsed() << "ms";
+    });
+
+    // Free up memory when the osd hasn't been used for a while. By default after 1 minute.
+    auto const group = KSharedConfig::openConfig(QStringLiteral("kdisplayrc"))
+                           ->group(QStringLiteral("OSD"));
+    m_cleanupTimer->setInterval(std::chrono::seconds(group.readEntry("IdleTimeout", 60)));
     m_cleanupTimer->setSingleShot(true);
-    connect(m_cleanupTimer, &QTimer::timeout, this, [this]() { quit(); });
+    connect(m_cleanupTimer, &QTimer::timeout, this, &OsdManager::quit);
+
     QDBusConnection::sessionBus().registerObject(
         QStringLiteral("/org/kwinft/kdisplay/osdService"), this, QDBusConnection::ExportAdaptors);
     QDBusConnection::sessionBus().registerService(QStringLiteral("org.kwinft.kdisplay.osdService"));
 }
 
+OsdManager::~OsdManager()
+{
+    // The view must go before the engine.
+    delete m_osd;
+}
+
 void OsdManager::hideOsd()
 {
-    // Let QML engine finish execution of signal handlers, if any.
-    QTimer::singleShot(0, this, &OsdManager::quit);
+    Trace::Span span("osd", "hideOsd");
+    reply(OsdAction::NoAction);
+    m_osd->hideOsd();
+
+    // Stay around for a while in case the osd is requested again.
+    m_cleanupTimer->start();
 }
 
 void OsdManager::quit()
 {
-    qDeleteAll(m_osds);
-    m_osds.clear();
+    reply(OsdAction::NoAction);
     qApp->quit();
 }
 
-OsdManager::~OsdManager() = default;
+void OsdManager::prepare()
+{
+    m_cleanupTimer->start();
+    m_osd->prepare();
+}
+
+void OsdManager::setProfiles(QStringList const& profiles)
+{
+    m_osd->setProfiles(profiles);
+}
 
-OsdAction::Action OsdManager::showActionSelector()
+OsdAction::Action OsdManager::showActionSelector(int& profile)
 {
+    profile = -1;
     setDelayedReply(true);
+    startRequest();
+    fetchAndShow();
+    return OsdAction::NoAction;
+}
+
+OsdAction::Action
+OsdManager::showActionSelectorOn(QString const& outputName, QRect const& geometry, int& profile)
+{
+    profile = -1;
+    setDelayedReply(true);
+    startRequest();
+
+    auto const screens = qGuiApp->screens();
+    for (auto screen : screens) {
+        if (screen->name() == outputName && screen->geometry() == geometry) {
+            m_osd->showActionSelector(screen);
+            return OsdAction::NoAction;
+        }
+    }
+
+    // Our view of the screens is behind the caller's or the other way around.
+    qCDebug(KDISPLAY_OSD) << "No screen" << outputName << "at" << geometry
+                          << "- fetching current config";
+    fetchAndShow();
+    return OsdAction::NoAction;
+}
+
+void OsdManager::startRequest()
+{
+    // A previous request still waiting for a selection is superseded.
+    reply(OsdAction::NoAction);
+
+    m_request = message();
+    m_requestTimer.start();
+    m_cleanupTimer->start();
+    Trace::asyncBegin("osd", "request", ++m_requestId);
+}
 
+static Snapshot::Output const* osdOutput(Snapshot::View const& view)
+{
+    // Same choice as Utils::osdOutput.
+    auto const usable = [](auto const& output) {
+        return (output.flags & Snapshot::Enabled) && output.modeWidth > 0;
+    };
+    for (int index = 0; index < view.outputCount(); index++) {
+        auto const& output = view.output(index);
+        if (usable(output)
+            && (output.type == Disman::Output::Panel || (output.flags & Snapshot::Primary))) {
+            return &output;
+        }
+    }
+    for (int index = 0; index < view.outputCount(); index++) {
+        if (usable(view.output(index))) {
+            return &view.output(index);
+        }
+    }
+    return nullptr;
+}
+
+void OsdManager::fetchAndShow()
+{
+    // The daemon's snapshot is usually mapped already and otherwise a single call away, while
+    // the backend would send the whole config.
+    Trace::asyncBegin("osd", "fetchSnapshot", m_requestId);
+    m_snapshot->get([this, requestId = m_requestId](auto const& view) {
+        Trace::asyncEnd("osd", "fetchSnapshot", requestId);
+        if (requestId != m_requestId || m_request.type() == QDBusMessage::InvalidMessage) {
+            return;
+        }
+
+        if (auto const output = osdOutput(view)) {
+            if (auto screen = qGuiApp->screenAt(view.geometry(*output).topLeft().toPoint())) {
+                qCDebug(KDISPLAY_OSD) << "Snapshot read after" << m_requestTimer.elapsed() << "ms";
+                m_osd->showActionSelector(screen);
+                return;
+            }
+        }
+        fetchConfigAndShow();
+    });
+}
+
+void OsdManager::fetchConfigAndShow()
+{
+    Trace::asyncBegin("osd", "fetchConfig", m_requestId);
     connect(new Disman::GetConfigOperation(),
             &Disman::GetConfigOperation::finished,
             this,
-            [this, message = message()](auto const op) {
-                if (op->has_error()) {
-                    qWarning() << op->error_string();
-                    auto error = message.createErrorReply(
-                        QDBusError::Failed,
-                        QStringLiteral("Failed to get current output configuration"));
-                    QDBusConnection::sessionBus().send(error);
+            [this, requestId = m_requestId](auto const op) {
+                Trace::asyncEnd("osd", "fetchConfig", requestId);
+                // Answered by hideOsd or superseded by a newer request meanwhile.
+                if (requestId != m_requestId || m_request.type() == QDBusMessage::InvalidMessage) {
                     return;
                 }
-
-                // Show selector on at most one of the enabled screens
-                auto const outputs = op->config()->outputs();
-                auto primary_output = op->config()->primary_output();
-                Disman::OutputPtr osdOutput;
-                for (auto const& [id, output] : outputs) {
-                    if (!output->enabled() || !output->commanded_mode()) {
-                        continue;
-                    }
-
-                    // Prefer laptop screen
-                    if (output->type() == Disman::Output::Panel) {
-                        osdOutput = output;
-                        break;
-                    }
-
-                    // Fallback to primary
-                    if (output == primary_output) {
-                        osdOutput = output;
-                        break;
-                    }
-                }
-
-                // no laptop or primary screen, just take the first usable one
-                if (!osdOutput) {
-                    for (auto const& [id, output] : outputs) {
-                        if (output->enabled() && output->commanded_mode()) {
-                            osdOutput = output;
-                            break;
-                        }
-                    }
-                }
-
-                if (!osdOutput) {
-                    auto error = message.createErrorReply(QDBusError::Failed,
-                                                          QStringLiteral("No enabled output"));
-                    QDBusConnection::sessionBus().send(error);
+                qCDebug(KDISPLAY_OSD) << "Config fetched after" << m_requestTimer.elapsed() << "ms";
+                if (op->has_error()) {
+                    qCWarning(KDISPLAY_OSD) << op->error_string();
+                    replyError(QStringLiteral("Failed to get current output configuration"));
                     return;
                 }
 
-                KDisplay::Osd* osd = nullptr;
-                if (m_osds.contains(osdOutput->name())) {
-                    osd = m_osds.value(osdOutput->name());
-                } else {
-                    osd = new KDisplay::Osd(osdOutput, this);
-                    m_osds.insert(osdOutput->name(), osd);
-                    connect(osd,
-                            &Osd::osdActionSelected,
-                            this,
-                            [this, message](OsdAction::Action action) {
-                                auto reply = message.createReply(action);
-                                QDBusConnection::sessionBus().send(reply);
-
-                                hideOsd();
-                            });
+                auto const output = Utils::osdOutput(op->config());
+                if (!output) {
+                    replyError(QStringLiteral("No enabled output"));
+                    return;
                 }
 
-                osd->showActionSelector();
-                connect(m_cleanupTimer, &QTimer::timeout, this, [message] {
-                    auto reply = message.createReply(OsdAction::NoAction);
-                    QDBusConnection::sessionBus().send(reply);
-                });
-                m_cleanupTimer->start();
+                auto screen = qGuiApp->screenAt(output->position().toPoint());
+                m_osd->showActionSelector(screen ? screen : qGuiApp->primaryScreen());
             });
-    return OsdAction::NoAction;
+}
+
+void OsdManager::reply(OsdAction::Action action, int profile)
+{
+    if (m_request.type() == QDBusMessage::InvalidMessage) {
+        return;
+    }
+    QDBusConnection::sessionBus().send(
+        m_request.createReply(QVariantList{static_cast<int>(action), profile}));
+    m_request = QDBusMessage();
+    Trace::asyncEnd("osd", "request", m_requestId);
+}
+
+void OsdManager::replyError(QString const& error)
+{
+    qCWarning(KDISPLAY_OSD) << error;
+    if (m_request.type() == QDBusMessage::InvalidMessage) {
+        return;
+    }
+    QDBusConnection::sessionBus().send(m_request.createErrorReply(QDBusError::Failed, error));
+    m_request = QDBusMessage();
+    Trace::asyncEnd("osd", "request", m_requestId);
 }
 
 }
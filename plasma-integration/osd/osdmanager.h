@@ -8,11 +8,17 @@
 #include "osdaction.h"
 
 #include <QDBusContext>
-#include <QMap>
+#include <QDBusMessage>
+#include <QElapsedTimer>
 #include <QObject>
+#include <QQmlEngine>
+#include <QRect>
 #include <QString>
+#include <QStringList>
 #include <QTimer>
 
+class SnapshotClient;
+
 namespace KDisplay
 {
 
@@ -28,12 +34,31 @@ public:
 
 public Q_SLOTS:
     void hideOsd();
-    OsdAction::Action showActionSelector();
+    void prepare();
+    void setProfiles(QStringList const& profiles);
+    /**
+     * The reply is delayed until a selection was made. It holds the action and in @p profile the
+     * index of a selected profile or -1.
+     */
+    OsdAction::Action showActionSelector(int& profile);
+    OsdAction::Action
+    showActionSelectorOn(QString const& outputName, QRect const& geometry, int& profile);
 
 private:
+    void startRequest();
+    void fetchAndShow();
+    void fetchConfigAndShow();
+    void reply(OsdAction::Action action, int profile = -1);
+    void replyError(QString const& error);
     void quit();
-    QMap<std::string, KDisplay::Osd*> m_osds;
+
+    QQmlEngine m_engine;
+    Osd* m_osd;
+    QDBusMessage m_request;
+    QElapsedTimer m_requestTimer;
+    uint64_t m_requestId = 0;
     QTimer* m_cleanupTimer;
+    SnapshotClient* m_snapshot;
 };
 
 } // ns
@@ -20,7 +20,8 @@ Control {
     id: root
     property string infoText
     property var actions
-    signal clicked(int actionId)
+    // The profile is -1 unless a profile was picked, then the action is NoAction.
+    signal clicked(int actionId, int profile)
 
     leftPadding: shadow.margins.left + background.margins.left
     rightPadding: shadow.margins.right + background.margins.right
@@ -35,6 +36,7 @@ Control {
                 model: root.actions
                 delegate: PlasmaComponents.Button {
                     property int actionId: modelData.action
+                    property int profile: modelData.profile
 
                     Accessible.name: modelData.label
 
@@ -42,7 +44,7 @@ Control {
                     icon.height: Kirigami.Units.gridUnit * 8
                     icon.width: Kirigami.Units.gridUnit * 8
 
-                    onClicked: root.clicked(actionId)
+                    onClicked: root.clicked(actionId, profile)
                     onHoveredChanged: {
                         actionRepeater.currentIndex = index
                     }
@@ -104,14 +106,15 @@ Control {
             switch (event.key) {
                 case Qt.Key_Return:
                 case Qt.Key_Enter:
-                    clicked(actionRepeater.itemAt(actionRepeater.currentIndex).actionId)
+                    const item = actionRepeater.itemAt(actionRepeater.currentIndex)
+                    clicked(item.actionId, item.profile)
                     break
                 case Qt.Key_Right:
                 case Qt.Key_Left:
                     move(event)
                     break
                 case Qt.Key_Escape:
-                    clicked(OsdAction.NoAction)
+                    clicked(OsdAction.NoAction, -1)
                     break
             }
         }
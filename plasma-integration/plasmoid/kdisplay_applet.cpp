@@ -22,45 +22,92 @@
  */
 #include "kdisplay_applet.h"
 
+#include "freedesktop_interface.h"
+
 #include <QMetaEnum>
-#include <QQmlEngine> // for qmlRegisterType
 
 #include <QDBusConnection>
 #include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+#include <QTimer>
 
-#include <disman/config.h>
-#include <disman/configmonitor.h>
-#include <disman/getconfigoperation.h>
-#include <disman/output.h>
+static QString const s_kdedService = QStringLiteral("org.kde.kded6");
+static QString const s_daemonPath = QStringLiteral("/modules/kdisplay");
+static QString const s_daemonInterface = QStringLiteral("org.kwinft.kdisplay");
 
-#include <algorithm>
+// Longer than an apply takes with all its retries.
+static constexpr int layout_request_timeout = 10000;
 
 KDisplayApplet::KDisplayApplet(QObject* parent,
                                const KPluginMetaData& data,
                                const QVariantList& args)
     : Plasma::Applet(parent, data, args)
+    , m_daemon(new OrgFreedesktopDBusPropertiesInterface(s_kdedService,
+                                                         s_daemonPath,
+                                                         QDBusConnection::sessionBus(),
+                                                         this))
 {
-    qmlRegisterUncreatableType<KDisplay::OsdAction>(
-        "org.kwinft.private.kdisplay", 1, 0, "OsdAction", QStringLiteral("Can't create OsdAction"));
 }
 
 KDisplayApplet::~KDisplayApplet() = default;
 
 void KDisplayApplet::init()
 {
-    connect(new Disman::GetConfigOperation,
-            &Disman::ConfigOperation::finished,
+    // The daemon keeps a summary of the outputs, so the applet does not need a config of its own.
+    connect(m_daemon,
+            &OrgFreedesktopDBusPropertiesInterface::PropertiesChanged,
             this,
-            [this](Disman::ConfigOperation* op) {
-                m_screenConfiguration = qobject_cast<Disman::GetConfigOperation*>(op)->config();
+            [this](QString const& interface, QVariantMap const& changed) {
+                if (interface == s_daemonInterface) {
+                    updateSummary(changed);
+                }
+            });
 
-                Disman::ConfigMonitor::instance()->add_config(m_screenConfiguration);
-                connect(Disman::ConfigMonitor::instance(),
-                        &Disman::ConfigMonitor::configuration_changed,
-                        this,
-                        &KDisplayApplet::checkOutputs);
+    m_layoutRequestTimer = new QTimer(this);
+    m_layoutRequestTimer->setSingleShot(true);
+    m_layoutRequestTimer->setInterval(layout_request_timeout);
+    connect(m_layoutRequestTimer, &QTimer::timeout, this, [this] { setLayoutRequestId(0); });
+
+    // A request of a daemon that went away is never answered, and a new one counts its requests
+    // from the start again.
+    auto watcher = new QDBusServiceWatcher(s_kdedService,
+                                           QDBusConnection::sessionBus(),
+                                           QDBusServiceWatcher::WatchForOwnerChange,
+                                           this);
+    connect(watcher, &QDBusServiceWatcher::serviceRegistered, this, [this] {
+        m_lastAppliedRequestId = 0;
+        setLayoutRequestId(0);
+        fetchSummary();
+    });
+    connect(watcher, &QDBusServiceWatcher::serviceUnregistered, this, [this] {
+        m_lastAppliedRequestId = 0;
+        setLayoutRequestId(0);
+    });
+
+    QDBusConnection::sessionBus().connect(s_kdedService,
+                                          s_daemonPath,
+                                          s_daemonInterface,
+                                          QStringLiteral("layoutApplied"),
+                                          this,
+                                          SLOT(onLayoutApplied(uint, bool, uint)));
+
+    fetchSummary();
+}
 
-                checkOutputs();
+void KDisplayApplet::fetchSummary()
+{
+    auto watcher = new QDBusPendingCallWatcher(m_daemon->GetAll(s_daemonInterface), this);
+    connect(watcher,
+            &QDBusPendingCallWatcher::finished,
+            this,
+            [this](QDBusPendingCallWatcher* watcher) {
+                watcher->deleteLater();
+                QDBusPendingReply<QVariantMap> reply = *watcher;
+                if (!reply.isError()) {
+                    updateSummary(reply.value());
+                }
             });
 }
 
@@ -69,34 +116,100 @@ int KDisplayApplet::connectedOutputCount() const
     return m_connectedOutputCount;
 }
 
+bool KDisplayApplet::applyingLayout() const
+{
+    return m_layoutRequestId != 0;
+}
+
+QStringList KDisplayApplet::profiles() const
+{
+    return m_profiles;
+}
+
 void KDisplayApplet::applyLayoutPreset(KDisplay::OsdAction::Action action)
 {
     auto const actionEnum = QMetaEnum::fromType<KDisplay::OsdAction::Action>();
     Q_ASSERT(actionEnum.isValid());
 
-    QDBusMessage msg = QDBusMessage::createMethodCall(QStringLiteral("org.kde.kded6"),
-                                                      QStringLiteral("/modules/kdisplay"),
-                                                      QStringLiteral("org.kwinft.kdisplay"),
-                                                      QStringLiteral("applyLayoutPreset"));
+    requestLayout(QStringLiteral("requestLayoutPreset"),
+                  QString::fromLatin1(actionEnum.valueToKey(action)));
+}
+
+void KDisplayApplet::applyProfile(QString const& name)
+{
+    requestLayout(QStringLiteral("requestProfile"), name);
+}
+
+void KDisplayApplet::requestLayout(QString const& method, QString const& argument)
+{
+    QDBusMessage msg
+        = QDBusMessage::createMethodCall(s_kdedService, s_daemonPath, s_daemonInterface, method);
 
-    msg.setArguments({QString::fromLatin1(actionEnum.valueToKey(action))});
+    msg.setArguments({argument});
 
-    QDBusConnection::sessionBus().call(msg, QDBus::NoBlock);
+    auto watcher
+        = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(msg), this);
+    connect(watcher,
+            &QDBusPendingCallWatcher::finished,
+            this,
+            [this](QDBusPendingCallWatcher* watcher) {
+                watcher->deleteLater();
+                QDBusPendingReply<uint> reply = *watcher;
+                if (reply.isError()) {
+                    return;
+                }
+                // The result may already be in when the layout was applied without delay.
+                if (reply.value() == m_lastAppliedRequestId) {
+                    return;
+                }
+                setLayoutRequestId(reply.value());
+            });
 }
 
-void KDisplayApplet::checkOutputs()
+void KDisplayApplet::setLayoutRequestId(uint requestId)
 {
-    if (!m_screenConfiguration) {
+    if (requestId) {
+        m_layoutRequestTimer->start();
+    } else {
+        m_layoutRequestTimer->stop();
+    }
+    if (requestId == m_layoutRequestId) {
         return;
     }
+    m_layoutRequestId = requestId;
+    Q_EMIT applyingLayoutChanged();
+}
 
-    const int oldConnectedOutputCount = m_connectedOutputCount;
+void KDisplayApplet::onLayoutApplied(uint requestId, bool success, uint elapsedMs)
+{
+    Q_UNUSED(success)
+    Q_UNUSED(elapsedMs)
 
-    const auto outputs = m_screenConfiguration->outputs();
-    m_connectedOutputCount = outputs.size();
+    m_lastAppliedRequestId = requestId;
+    if (requestId != m_layoutRequestId) {
+        return;
+    }
+    setLayoutRequestId(0);
+}
+
+void KDisplayApplet::updateSummary(QVariantMap const& properties)
+{
+    auto it = properties.constFind(QStringLiteral("connectedOutputCount"));
+    if (it != properties.constEnd()) {
+        auto const count = it->toInt();
+        if (count != m_connectedOutputCount) {
+            m_connectedOutputCount = count;
+            Q_EMIT connectedOutputCountChanged();
+        }
+    }
 
-    if (m_connectedOutputCount != oldConnectedOutputCount) {
-        Q_EMIT connectedOutputCountChanged();
+    it = properties.constFind(QStringLiteral("profiles"));
+    if (it != properties.constEnd()) {
+        auto const profiles = it->toStringList();
+        if (profiles != m_profiles) {
+            m_profiles = profiles;
+            Q_EMIT profilesChanged();
+        }
     }
 }
 
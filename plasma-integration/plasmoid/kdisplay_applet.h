@@ -25,7 +25,11 @@
 #include "../osd/osdaction.h"
 
 #include <Plasma/Applet>
-#include <disman/types.h>
+
+#include <QStringList>
+
+class OrgFreedesktopDBusPropertiesInterface;
+class QTimer;
 
 class KDisplayApplet : public Plasma::Applet
 {
@@ -37,6 +41,16 @@ class KDisplayApplet : public Plasma::Applet
     Q_PROPERTY(
         int connectedOutputCount READ connectedOutputCount NOTIFY connectedOutputCountChanged)
 
+    /**
+     * Whether a layout preset requested from the applet is still being applied
+     */
+    Q_PROPERTY(bool applyingLayout READ applyingLayout NOTIFY applyingLayoutChanged)
+
+    /**
+     * The names of the layout profiles saved for the connected outputs
+     */
+    Q_PROPERTY(QStringList profiles READ profiles NOTIFY profilesChanged)
+
 public:
     explicit KDisplayApplet(QObject* parent, const KPluginMetaData& data, const QVariantList& args);
     ~KDisplayApplet() override;
@@ -44,15 +58,32 @@ public:
     void init() override;
 
     int connectedOutputCount() const;
+    bool applyingLayout() const;
+    QStringList profiles() const;
 
     Q_INVOKABLE void applyLayoutPreset(KDisplay::OsdAction::Action action);
+    Q_INVOKABLE void applyProfile(QString const& name);
 
 Q_SIGNALS:
     void connectedOutputCountChanged();
+    void applyingLayoutChanged();
+    void profilesChanged();
+
+private Q_SLOTS:
+    void onLayoutApplied(uint requestId, bool success, uint elapsedMs);
 
 private:
-    void checkOutputs();
+    void fetchSummary();
+    void updateSummary(QVariantMap const& properties);
+    void requestLayout(QString const& method, QString const& argument);
+    void setLayoutRequestId(uint requestId);
 
-    Disman::ConfigPtr m_screenConfiguration;
+    OrgFreedesktopDBusPropertiesInterface* m_daemon;
     int m_connectedOutputCount = 0;
+    QStringList m_profiles;
+    // The id of the pending request, 0 for none.
+    uint m_layoutRequestId = 0;
+    uint m_lastAppliedRequestId = 0;
+    // Gives up on the pending request when layoutApplied never comes.
+    QTimer* m_layoutRequestTimer = nullptr;
 };
@@ -60,6 +60,7 @@ ColumnLayout {
         readonly property int buttonSize: Math.floor((width - spacing * (screenLayoutRepeater.count - 1)) / screenLayoutRepeater.count)
         Layout.fillWidth: true
         spacing: Kirigami.Units.smallSpacing
+        enabled: !Plasmoid.applyingLayout
 
         Repeater {
             id: screenLayoutRepeater
@@ -86,6 +87,25 @@ ColumnLayout {
         }
     }
 
+    // Profiles are saved for the connected outputs, so they apply even with a single one.
+    Flow {
+        Layout.fillWidth: true
+        Layout.topMargin: Kirigami.Units.smallSpacing
+        spacing: Kirigami.Units.smallSpacing
+        enabled: !Plasmoid.applyingLayout
+        visible: Plasmoid.profiles.length > 0
+
+        Repeater {
+            model: Plasmoid.profiles
+
+            PlasmaComponents3.Button {
+                icon.name: "video-display"
+                text: modelData
+                onClicked: Plasmoid.applyProfile(modelData)
+            }
+        }
+    }
+
     PlasmaExtras.DescriptiveLabel {
         id: noScreenLabel
         Layout.fillWidth: true
@@ -0,0 +1,170 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "fake_config.h"
+
+#include "../../kcm/config_handler.h"
+#include "../../kcm/output_model.h"
+
+#include <disman/config.h>
+#include <disman/output.h>
+
+#include <QObject>
+#include <QtTest>
+
+#include <memory>
+
+/**
+ * Benchmarks the model behind the display settings on generated configs of increasing size.
+ */
+class KcmBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void data_data();
+    void data();
+    void dragPosition_data();
+    void dragPosition();
+    void updateOrder_data();
+    void updateOrder();
+    void checkNeedsSave_data();
+    void checkNeedsSave();
+
+private:
+    void sizes();
+    std::unique_ptr<ConfigHandler> handler();
+};
+
+void KcmBenchmark::sizes()
+{
+    QTest::addColumn<int>("outputs");
+    QTest::addColumn<int>("modes");
+
+    QTest::newRow("1 output, 10 modes") << 1 << 10;
+    QTest::newRow("2 outputs, 50 modes") << 2 << 50;
+    QTest::newRow("8 outputs, 100 modes") << 8 << 100;
+    QTest::newRow("32 outputs, 500 modes") << 32 << 500;
+}
+
+std::unique_ptr<ConfigHandler> KcmBenchmark::handler()
+{
+    QFETCH(int, outputs);
+    QFETCH(int, modes);
+
+    auto config = Bench::loadConfig(outputs, modes);
+    if (!config) {
+        return nullptr;
+    }
+    auto handler = std::make_unique<ConfigHandler>();
+    handler->setConfig(config);
+    return handler;
+}
+
+void KcmBenchmark::data_data()
+{
+    sizes();
+}
+
+void KcmBenchmark::data()
+{
+    auto const handler = this->handler();
+    QVERIFY(handler);
+
+    // Through the base, which has the role names public.
+    QAbstractItemModel const* model = handler->outputModel();
+    auto const roles = model->roleNames().keys();
+
+    // What the view reads when it is populated.
+    QBENCHMARK {
+        for (int row = 0; row < model->rowCount(); row++) {
+            auto const index = model->index(row, 0);
+            for (auto const role : roles) {
+                model->data(index, role);
+            }
+        }
+    }
+}
+
+void KcmBenchmark::dragPosition_data()
+{
+    sizes();
+}
+
+void KcmBenchmark::dragPosition()
+{
+    auto const handler = this->handler();
+    QVERIFY(handler);
+
+    auto model = handler->outputModel();
+    auto const index = model->index(0);
+    auto const start = model->data(index, OutputModel::PositionRole).toPoint();
+
+    // Drag the first output across all others and back in small steps, like a pointer would.
+    int const width = int(handler->config()->outputs().size()) * 2000;
+    int const steps = 100;
+    QBENCHMARK {
+        for (int step = 1; step <= steps; step++) {
+            model->setData(index,
+                           start + QPoint(width * step / steps, step % 7),
+                           OutputModel::PositionRole);
+        }
+        for (int step = steps - 1; step >= 0; step--) {
+            model->setData(index,
+                           start + QPoint(width * step / steps, step % 7),
+                           OutputModel::PositionRole);
+        }
+    }
+}
+
+void KcmBenchmark::updateOrder_data()
+{
+    sizes();
+}
+
+void KcmBenchmark::updateOrder()
+{
+    auto const handler = this->handler();
+    QVERIFY(handler);
+
+    auto model = handler->outputModel();
+
+    // Alternate between the layout and its mirror image so every call reorders all rows.
+    std::vector<std::pair<Disman::OutputPtr, QPointF>> mirrored;
+    for (auto const& [id, output] : handler->config()->outputs()) {
+        mirrored.emplace_back(output, QPointF(-output->position().x(), output->position().y()));
+    }
+    QBENCHMARK {
+        for (auto& [output, position] : mirrored) {
+            auto const current = output->position();
+            output->set_position(position);
+            position = current;
+        }
+        model->updateOrder();
+    }
+}
+
+void KcmBenchmark::checkNeedsSave_data()
+{
+    sizes();
+}
+
+void KcmBenchmark::checkNeedsSave()
+{
+    auto const handler = this->handler();
+    QVERIFY(handler);
+
+    // Unchanged is the worst case since every output is compared.
+    QSignalSpy spy(handler.get(), &ConfigHandler::needsSaveChecked);
+    QBENCHMARK {
+        handler->checkNeedsSave();
+    }
+    QVERIFY(!spy.isEmpty());
+    QCOMPARE(spy.last().first().toBool(), false);
+}
+
+QTEST_MAIN(KcmBenchmark)
+
+#include "benchkcm.moc"
@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "fake_config.h"
+
+#include "../../plasma-integration/kded/config.h"
+#include "../../plasma-integration/kded/generator.h"
+
+#include <disman/config.h>
+#include <disman/output.h>
+
+#include <QObject>
+#include <QtTest>
+
+/**
+ * Benchmarks what the daemon computes on a hotplug or an orientation change, on generated
+ * configs of increasing size.
+ */
+class KdedBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void displaySwitch_data();
+    void displaySwitch();
+    void setDeviceOrientation_data();
+    void setDeviceOrientation();
+};
+
+void KdedBenchmark::displaySwitch_data()
+{
+    QTest::addColumn<KDisplay::OsdAction::Action>("action");
+    QTest::addColumn<int>("modes");
+
+    // The layout presets are for one panel and one external output.
+    auto const actions = QMetaEnum::fromType<KDisplay::OsdAction::Action>();
+    for (auto const action : {KDisplay::OsdAction::SwitchToExternal,
+                              KDisplay::OsdAction::SwitchToInternal,
+                              KDisplay::OsdAction::Clone,
+                              KDisplay::OsdAction::ExtendLeft,
+                              KDisplay::OsdAction::ExtendRight}) {
+        for (auto const modes : {10, 100, 500}) {
+            QTest::addRow("%s, %d modes", actions.valueToKey(action), modes) << action << modes;
+        }
+    }
+}
+
+void KdedBenchmark::displaySwitch()
+{
+    QFETCH(KDisplay::OsdAction::Action, action);
+    QFETCH(int, modes);
+
+    auto const config = Bench::loadConfig(2, modes);
+    QVERIFY(config);
+
+    QBENCHMARK {
+        Generator::displaySwitch(action, config);
+    }
+}
+
+void KdedBenchmark::setDeviceOrientation_data()
+{
+    QTest::addColumn<int>("outputs");
+    QTest::addColumn<int>("panels");
+
+    QTest::newRow("1 output") << 1 << 1;
+    QTest::newRow("8 outputs") << 8 << 1;
+    QTest::newRow("32 outputs") << 32 << 1;
+
+    // Without a panel every output is looked at.
+    QTest::newRow("32 outputs, no panel") << 32 << 0;
+}
+
+void KdedBenchmark::setDeviceOrientation()
+{
+    QFETCH(int, outputs);
+    QFETCH(int, panels);
+
+    ConfigGen::Options options;
+    options.outputs = outputs;
+    options.panels = panels;
+    options.disabledPercent = 0;
+    auto const config = Bench::loadConfig(options);
+    QVERIFY(config);
+
+    config->set_supported_features(Disman::Config::Feature::AutoRotation
+                                   | Disman::Config::Feature::TabletMode);
+    for (auto const& [id, output] : config->outputs()) {
+        output->set_auto_rotate(true);
+        output->set_auto_rotate_only_in_tablet_mode(false);
+    }
+
+    Config wrapper(config);
+    bool flip = false;
+    QBENCHMARK {
+        wrapper.setDeviceOrientation(flip ? QOrientationReading::LeftUp
+                                          : QOrientationReading::TopUp);
+        flip = !flip;
+    }
+}
+
+QTEST_GUILESS_MAIN(KdedBenchmark)
+
+#include "benchkded.moc"
@@ -0,0 +1,60 @@
+#!/usr/bin/env bash
+
+# SPDX-FileCopyrightText: 2026 KDisplay Contributors
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+# Compares benchmark results in the CSV format of QtTest (-o file,csv) with a baseline and fails
+# when a result got slower than the baseline by more than the threshold in percent.
+#
+# Usage: compare_baseline.sh <baseline.csv> <results.csv> [threshold]
+
+set -eu
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 <baseline.csv> <results.csv> [threshold]" >&2
+    exit 2
+fi
+
+baseline=$1
+results=$2
+threshold=${3:-20}
+
+if [ ! -f "$baseline" ]; then
+    echo "No baseline at $baseline, nothing to compare."
+    exit 0
+fi
+
+# Each line is "function","tag","metric",per-iteration,total,iterations. Tags may contain commas,
+# so split off the numbers from the end.
+split() {
+    sed -E 's/^(.*),([^,]*),([^,]*),([^,]*)$/\1\t\2/' "$1"
+}
+
+awk -F '\t' -v threshold="$threshold" '
+    NR == FNR {
+        base[$1] = $2
+        next
+    }
+    !($1 in base) {
+        printf "new        %s: %g\n", $1, $2
+        next
+    }
+    {
+        if (base[$1] <= 0) {
+            next
+        }
+        change = ($2 - base[$1]) * 100 / base[$1]
+        status = change > threshold ? "REGRESSION" : "ok"
+        printf "%-10s %s: %g -> %g (%+.1f%%)\n", status, $1, base[$1], $2, change
+        if (change > threshold) {
+            failed++
+        }
+    }
+    END {
+        if (failed) {
+            printf "%d result(s) slower than the baseline by more than %s%%\n", failed, threshold
+            exit 1
+        }
+    }
+' <(split "$baseline") <(split "$results")
@@ -0,0 +1,40 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "fake_config.h"
+
+#include "fake_backend.h"
+
+#include <QDebug>
+#include <QTemporaryDir>
+
+namespace Bench
+{
+
+Disman::ConfigPtr loadConfig(ConfigGen::Options const& options)
+{
+    static QTemporaryDir dir;
+    auto const path = dir.filePath(QStringLiteral("%1-%2-%3.json")
+                                       .arg(options.outputs)
+                                       .arg(options.modesPerOutput)
+                                       .arg(options.seed));
+    if (!ConfigGen::write(options, path)) {
+        qWarning() << "Could not write" << path;
+        return nullptr;
+    }
+
+    return FakeBackend::load(path);
+}
+
+Disman::ConfigPtr loadConfig(int outputs, int modes)
+{
+    ConfigGen::Options options;
+    options.outputs = outputs;
+    options.modesPerOutput = modes;
+    options.disabledPercent = 0;
+    return loadConfig(options);
+}
+
+}
@@ -0,0 +1,25 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "configgen.h"
+
+#include <disman/types.h>
+
+namespace Bench
+{
+
+/**
+ * Generates a config with @p options and loads it through the fake backend.
+ */
+Disman::ConfigPtr loadConfig(ConfigGen::Options const& options);
+
+/**
+ * Convenience for the common case of one panel plus external outputs.
+ */
+Disman::ConfigPtr loadConfig(int outputs, int modes);
+
+}
@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../plasma-integration/osd/osdaction.h"
+
+#include <KPluginMetaData>
+#include <KQuickConfigModule>
+#include <KQuickConfigModuleLoader>
+
+#include <QElapsedTimer>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickView>
+#include <QSignalSpy>
+#include <QtTest>
+
+#include <memory>
+
+/**
+ * Measures the time from starting to load a QML UI until its first frame was rendered. Only the
+ * first load is cold, so CMake runs every case in a process of its own.
+ */
+class QmlStartupBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void osdSelector();
+    void kcm();
+};
+
+void QmlStartupBenchmark::osdSelector()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QQmlEngine engine;
+    engine.setProperty("_kirigamiTheme", QStringLiteral("KirigamiPlasmaStyle"));
+
+    QQuickView view(&engine, nullptr);
+    view.setInitialProperties(
+        {{QLatin1String("actions"), QVariant::fromValue(KDisplay::OsdAction::availableActions())}});
+    view.setSource(QUrl(QStringLiteral("qrc:/qt/qml/org/kwinft/kdisplay/OsdSelector.qml")));
+    QCOMPARE(view.status(), QQuickView::Ready);
+
+    QSignalSpy frameSpy(&view, &QQuickWindow::frameSwapped);
+    view.show();
+    QVERIFY(frameSpy.wait());
+
+    QTest::setBenchmarkResult(timer.elapsed(), QTest::WalltimeMilliseconds);
+}
+
+void QmlStartupBenchmark::kcm()
+{
+    KPluginMetaData const data(QStringLiteral("plasma/kcms/systemsettings/kcm_kdisplay"));
+    if (!data.isValid()) {
+        QSKIP("KCM plugin not found");
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    auto result = KQuickConfigModuleLoader::loadModule(data, nullptr, {});
+    QVERIFY(result);
+
+    std::unique_ptr<KQuickConfigModule> module(result.plugin);
+    module->load();
+
+    auto item = module->mainUi();
+    QVERIFY(item);
+
+    QQuickWindow window;
+    item->setParentItem(window.contentItem());
+    window.resize(800, 600);
+
+    QSignalSpy frameSpy(&window, &QQuickWindow::frameSwapped);
+    window.show();
+    QVERIFY(frameSpy.wait());
+
+    QTest::setBenchmarkResult(timer.elapsed(), QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(QmlStartupBenchmark)
+
+#include "qmlstartup.moc"
@@ -0,0 +1,271 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../common/fingerprint.h"
+#include "../../plasma-integration/cli/cli.h"
+#include "fake_backend.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+#include <disman/mode.h>
+#include <disman/output.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QObject>
+#include <QProcess>
+#include <QtTest>
+
+using namespace Disman;
+
+class TestCli : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void describe();
+    void preset();
+    void layoutRoundTrip();
+    void layoutMode();
+    void layoutEnable();
+    void layoutOnPreset();
+    void layoutErrors_data();
+    void layoutErrors();
+    void process();
+
+private:
+    ConfigPtr loadConfig(QByteArray const& fileName);
+    OutputPtr outputNamed(ConfigPtr const& config, std::string const& name);
+};
+
+ConfigPtr TestCli::loadConfig(QByteArray const& fileName)
+{
+    auto config = FakeBackend::loadFixture(fileName);
+    if (!config) {
+        return nullptr;
+    }
+    config->set_supported_features(Config::Feature::PrimaryDisplay);
+    return config;
+}
+
+OutputPtr TestCli::outputNamed(ConfigPtr const& config, std::string const& name)
+{
+    for (auto const& [id, output] : config->outputs()) {
+        if (output->name() == name) {
+            return output;
+        }
+    }
+    return nullptr;
+}
+
+void TestCli::initTestCase()
+{
+    qputenv("DISMAN_IN_PROCESS", "1");
+    qputenv("DISMAN_LOGGING", "false");
+    qputenv("DISMAN_BACKEND", "fake");
+}
+
+void TestCli::cleanupTestCase()
+{
+    BackendManager::instance()->shutdown_backend();
+}
+
+void TestCli::describe()
+{
+    auto const config = loadConfig("laptopAndExternal.json");
+    QVERIFY(config);
+
+    auto const description = Cli::describe(config);
+    QCOMPARE(description.value(QStringLiteral("primary")).toString(), QStringLiteral("LVDS1"));
+
+    auto const outputs = description.value(QStringLiteral("outputs")).toArray();
+    QCOMPARE(outputs.size(), 2);
+
+    auto const laptop = outputs.at(0).toObject();
+    QCOMPARE(laptop.value(QStringLiteral("name")).toString(), QStringLiteral("LVDS1"));
+    QVERIFY(laptop.value(QStringLiteral("enabled")).toBool());
+    QCOMPARE(laptop.value(QStringLiteral("rotation")).toString(), QStringLiteral("none"));
+    auto const mode = laptop.value(QStringLiteral("mode")).toObject();
+    QCOMPARE(mode.value(QStringLiteral("width")).toInt(), 1280);
+    QCOMPARE(mode.value(QStringLiteral("height")).toInt(), 800);
+
+    // Disabled outputs only have what identifies them.
+    auto const external = outputs.at(1).toObject();
+    QCOMPARE(external.value(QStringLiteral("name")).toString(), QStringLiteral("HDMI1"));
+    QVERIFY(!external.value(QStringLiteral("enabled")).toBool());
+    QVERIFY(!external.contains(QStringLiteral("mode")));
+
+    QVERIFY(Cli::describeText(config).contains(QStringLiteral("HDMI1: disabled")));
+}
+
+void TestCli::preset()
+{
+    auto const config = loadConfig("laptopAndExternal.json");
+    QVERIFY(config);
+
+    auto const result = Cli::preset(QStringLiteral("ExtendRight"), config);
+    QVERIFY2(result.config, qPrintable(result.error));
+    auto const laptop = outputNamed(result.config, "LVDS1");
+    auto const external = outputNamed(result.config, "HDMI1");
+    QVERIFY(laptop->enabled());
+    QVERIFY(external->enabled());
+    QVERIFY(!laptop->geometry().intersects(external->geometry()));
+
+    QVERIFY(!Cli::preset(QStringLiteral("NoAction"), config).config);
+    QVERIFY(!Cli::preset(QStringLiteral("Sideways"), config).error.isEmpty());
+
+    auto const single = loadConfig("singleOutput.json");
+    QVERIFY(single);
+    QVERIFY(!Cli::preset(QStringLiteral("Clone"), single).config);
+}
+
+void TestCli::layoutRoundTrip()
+{
+    auto const config = loadConfig("laptopAndTwoExternal.json");
+    QVERIFY(config);
+
+    // A layout as it was listed changes nothing.
+    auto const result = Cli::layout(Cli::describe(config), config);
+    QVERIFY2(result.config, qPrintable(result.error));
+    QCOMPARE(Fingerprint::config(result.config), Fingerprint::config(config));
+    QVERIFY(result.config != config);
+}
+
+void TestCli::layoutMode()
+{
+    auto const config = loadConfig("laptopAndExternal.json");
+    QVERIFY(config);
+    auto const fingerprint = Fingerprint::config(config);
+
+    auto const layout = QJsonDocument::fromJson(R"({"outputs": [
+        {"name": "LVDS1", "mode": {"width": 1024, "height": 768}, "scale": 1.25}
+    ]})");
+    auto const result = Cli::layout(layout.object(), config);
+    QVERIFY2(result.config, qPrintable(result.error));
+
+    auto const laptop = outputNamed(result.config, "LVDS1");
+    QCOMPARE(laptop->auto_mode()->size(), QSize(1024, 768));
+    QVERIFY(!laptop->auto_resolution());
+    QCOMPARE(laptop->scale(), 1.25);
+
+    // The current config is left alone.
+    QCOMPARE(Fingerprint::config(config), fingerprint);
+}
+
+void TestCli::layoutEnable()
+{
+    auto const config = loadConfig("laptopAndExternal.json");
+    QVERIFY(config);
+
+    auto const layout = QJsonDocument::fromJson(R"({"primary": "HDMI1", "outputs": [
+        {"name": "HDMI1", "enabled": true, "position": {"x": 1280, "y": 0},
+         "mode": {"width": 1920, "height": 1080, "refresh": 60}, "rotation": "left"}
+    ]})");
+    auto const result = Cli::layout(layout.object(), config);
+    QVERIFY2(result.config, qPrintable(result.error));
+
+    auto const external = outputNamed(result.config, "HDMI1");
+    QVERIFY(external->enabled());
+    QCOMPARE(external->position(), QPointF(1280, 0));
+    QCOMPARE(external->auto_mode()->size(), QSize(1920, 1080));
+    QCOMPARE(external->rotation(), Output::Rotation::Left);
+    QCOMPARE(result.config->primary_output(), external);
+}
+
+void TestCli::layoutOnPreset()
+{
+    auto const config = loadConfig("laptopAndExternal.json");
+    QVERIFY(config);
+
+    auto const layout = QJsonDocument::fromJson(R"({"preset": "ExtendLeft", "outputs": [
+        {"name": "LVDS1", "scale": 2}
+    ]})");
+    auto const result = Cli::layout(layout.object(), config);
+    QVERIFY2(result.config, qPrintable(result.error));
+    QVERIFY(outputNamed(result.config, "HDMI1")->enabled());
+    QCOMPARE(outputNamed(result.config, "LVDS1")->scale(), 2.);
+}
+
+void TestCli::layoutErrors_data()
+{
+    QTest::addColumn<QByteArray>("layout");
+
+    QTest::newRow("unknown output") << QByteArray(R"({"outputs": [{"name": "DP-9"}]})");
+    QTest::newRow("unknown mode")
+        << QByteArray(R"({"outputs": [{"name": "LVDS1", "mode": {"width": 1, "height": 1}}]})");
+    QTest::newRow("unknown mode id")
+        << QByteArray(R"({"outputs": [{"name": "LVDS1", "mode": {"id": "none"}}]})");
+    QTest::newRow("rotation")
+        << QByteArray(R"({"outputs": [{"name": "LVDS1", "rotation": "sideways"}]})");
+    QTest::newRow("scale") << QByteArray(R"({"outputs": [{"name": "LVDS1", "scale": 0}]})");
+    QTest::newRow("replicates itself")
+        << QByteArray(R"({"outputs": [{"name": "LVDS1", "replicationSource": "LVDS1"}]})");
+    QTest::newRow("all disabled")
+        << QByteArray(R"({"outputs": [{"name": "LVDS1", "enabled": false}]})");
+    QTest::newRow("unknown primary") << QByteArray(R"({"primary": "DP-9"})");
+    QTest::newRow("unknown preset") << QByteArray(R"({"preset": "Sideways"})");
+}
+
+void TestCli::layoutErrors()
+{
+    QFETCH(QByteArray, layout);
+
+    auto const config = loadConfig("laptopAndExternal.json");
+    QVERIFY(config);
+
+    auto const result = Cli::layout(QJsonDocument::fromJson(layout).object(), config);
+    QVERIFY(!result.config);
+    QVERIFY(!result.error.isEmpty());
+}
+
+void TestCli::process()
+{
+    QProcess cli;
+    auto environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(QStringLiteral("DISMAN_BACKEND_ARGS"),
+                       QStringLiteral("TEST_DATA=")
+                           + FakeBackend::fixture("laptopAndExternal.json"));
+    cli.setProcessEnvironment(environment);
+
+    cli.start(QStringLiteral(CLI_EXECUTABLE), {QStringLiteral("--json"), QStringLiteral("list")});
+    QVERIFY(cli.waitForFinished());
+    QCOMPARE(cli.exitCode(), 0);
+    auto const list = QJsonDocument::fromJson(cli.readAllStandardOutput()).object();
+    QCOMPARE(list.value(QStringLiteral("outputs")).toArray().size(), 2);
+
+    cli.start(QStringLiteral(CLI_EXECUTABLE),
+              {QStringLiteral("--json"),
+               QStringLiteral("--dry-run"),
+               QStringLiteral("preset"),
+               QStringLiteral("ExtendRight")});
+    QVERIFY(cli.waitForFinished());
+    QCOMPARE(cli.exitCode(), 0);
+    auto const preset = QJsonDocument::fromJson(cli.readAllStandardOutput()).object();
+    QVERIFY(preset.value(QStringLiteral("changed")).toBool());
+    QVERIFY(!preset.value(QStringLiteral("applied")).toBool());
+
+    cli.start(QStringLiteral(CLI_EXECUTABLE),
+              {QStringLiteral("--json"), QStringLiteral("preset"), QStringLiteral("Sideways")});
+    QVERIFY(cli.waitForFinished());
+    QCOMPARE(cli.exitCode(), 1);
+    QVERIFY(QJsonDocument::fromJson(cli.readAllStandardOutput())
+                .object()
+                .contains(QStringLiteral("error")));
+
+    // The usage goes to stderr, also with --json.
+    cli.start(QStringLiteral(CLI_EXECUTABLE),
+              {QStringLiteral("--json"), QStringLiteral("frobnicate")});
+    QVERIFY(cli.waitForFinished());
+    QCOMPARE(cli.exitCode(), 2);
+    QVERIFY(cli.readAllStandardOutput().isEmpty());
+    QVERIFY(!cli.readAllStandardError().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestCli)
+
+#include "testcli.moc"
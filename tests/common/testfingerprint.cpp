@@ -0,0 +1,158 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../common/fingerprint.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+#include <disman/output.h>
+
+#include <QObject>
+#include <QtTest>
+
+#include <functional>
+
+using namespace Disman;
+
+class TestFingerprint : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void equalConfigs();
+    void settings();
+    void disabledOutput();
+    void primary();
+    void setup();
+};
+
+void TestFingerprint::initTestCase()
+{
+    qputenv("DISMAN_IN_PROCESS", "1");
+    qputenv("DISMAN_LOGGING", "false");
+    qputenv("DISMAN_BACKEND", "fake");
+}
+
+void TestFingerprint::cleanupTestCase()
+{
+    BackendManager::instance()->shutdown_backend();
+}
+
+void TestFingerprint::equalConfigs()
+{
+    auto const config = FakeBackend::loadFixture("laptopAndExternal.json");
+    QVERIFY(config);
+
+    QVERIFY(Fingerprint::config(config) != 0);
+    QCOMPARE(Fingerprint::config(config->clone()), Fingerprint::config(config));
+    QCOMPARE(Fingerprint::config(FakeBackend::loadFixture("laptopAndExternal.json")),
+             Fingerprint::config(config));
+
+    QVERIFY(Fingerprint::config(FakeBackend::loadFixture("switchDisplayTwoScreens.json"))
+            != Fingerprint::config(config));
+    QCOMPARE(Fingerprint::config(nullptr), uint64_t(0));
+}
+
+void TestFingerprint::settings()
+{
+    std::vector<std::pair<char const*, std::function<void(OutputPtr const&)>>> const changes{
+        {"enabled", [](auto const& output) { output->set_enabled(false); }},
+        {"position",
+         [](auto const& output) { output->set_position(output->position() + QPointF(10, 0)); }},
+        {"scale", [](auto const& output) { output->set_scale(1.25); }},
+        {"rotation", [](auto const& output) { output->set_rotation(Output::Rotation::Left); }},
+        {"adaptive sync",
+         [](auto const& output) { output->set_adaptive_sync(!output->adaptive_sync()); }},
+        {"replication", [](auto const& output) { output->set_replication_source(2); }},
+        {"retention",
+         [](auto const& output) {
+             output->set_retention(output->retention() == Output::Retention::Individual
+                                       ? Output::Retention::Global
+                                       : Output::Retention::Individual);
+         }},
+        {"auto resolution",
+         [](auto const& output) { output->set_auto_resolution(!output->auto_resolution()); }},
+        {"auto refresh rate",
+         [](auto const& output) { output->set_auto_refresh_rate(!output->auto_refresh_rate()); }},
+        {"auto rotate", [](auto const& output) { output->set_auto_rotate(!output->auto_rotate()); }},
+        {"auto rotate in tablet mode",
+         [](auto const& output) {
+             output->set_auto_rotate_only_in_tablet_mode(!output->auto_rotate_only_in_tablet_mode());
+         }},
+    };
+
+    for (auto const& [name, change] : changes) {
+        auto const config = FakeBackend::loadFixture("laptopAndExternal.json");
+        QVERIFY(config);
+        auto const output = config->outputs().at(1);
+        QVERIFY(output->enabled());
+
+        auto const outputBefore = Fingerprint::output(output);
+        auto const configBefore = Fingerprint::config(config);
+        change(output);
+        QVERIFY2(Fingerprint::output(output) != outputBefore, name);
+        QVERIFY2(Fingerprint::config(config) != configBefore, name);
+    }
+}
+
+void TestFingerprint::disabledOutput()
+{
+    auto const config = FakeBackend::loadFixture("laptopAndExternal.json");
+    QVERIFY(config);
+    auto const output = config->outputs().at(2);
+    QVERIFY(!output->enabled());
+
+    // Nothing but the enabled state counts for a disabled output.
+    auto const before = Fingerprint::output(output);
+    output->set_position(QPointF(4000, 0));
+    output->set_scale(2);
+    output->set_auto_rotate(!output->auto_rotate());
+    QCOMPARE(Fingerprint::output(output), before);
+}
+
+void TestFingerprint::primary()
+{
+    auto const config = FakeBackend::loadFixture("laptopAndExternal.json");
+    QVERIFY(config);
+    config->outputs().at(2)->set_enabled(true);
+
+    config->set_supported_features(Config::Feature::PrimaryDisplay);
+    config->set_primary_output(config->outputs().at(1));
+    auto const before = Fingerprint::config(config);
+    config->set_primary_output(config->outputs().at(2));
+    QVERIFY(Fingerprint::config(config) != before);
+
+    // Ignored when the backend has no notion of a primary output.
+    config->set_supported_features({});
+    auto const unsupported = Fingerprint::config(config);
+    config->set_primary_output(config->outputs().at(1));
+    QCOMPARE(Fingerprint::config(config), unsupported);
+}
+
+void TestFingerprint::setup()
+{
+    auto const config = FakeBackend::loadFixture("laptopAndExternal.json");
+    QVERIFY(config);
+    auto const setup = Fingerprint::setup(config);
+    QVERIFY(setup != 0);
+
+    // Any layout of the same outputs.
+    auto const changed = config->clone();
+    changed->outputs().at(2)->set_enabled(true);
+    changed->outputs().at(1)->set_scale(2);
+    QCOMPARE(Fingerprint::setup(changed), setup);
+    QVERIFY(Fingerprint::config(changed) != Fingerprint::config(config));
+
+    QVERIFY(Fingerprint::setup(FakeBackend::loadFixture("laptopAndTwoExternal.json")) != setup);
+    QCOMPARE(Fingerprint::setup(nullptr), uint64_t(0));
+}
+
+QTEST_GUILESS_MAIN(TestFingerprint)
+
+#include "testfingerprint.moc"
+#include "fake_backend.h"
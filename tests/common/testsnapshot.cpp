@@ -0,0 +1,153 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../common/fingerprint.h"
+#include "../../common/snapshot.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+#include <disman/mode.h>
+#include <disman/output.h>
+
+#include <QObject>
+#include <QtTest>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace Disman;
+
+class TestSnapshot : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void roundTrip();
+    void empty();
+    void invalid();
+    void sealedFd();
+};
+
+void TestSnapshot::initTestCase()
+{
+    qputenv("DISMAN_IN_PROCESS", "1");
+    qputenv("DISMAN_LOGGING", "false");
+    qputenv("DISMAN_BACKEND", "fake");
+}
+
+void TestSnapshot::cleanupTestCase()
+{
+    BackendManager::instance()->shutdown_backend();
+}
+
+void TestSnapshot::roundTrip()
+{
+    auto const config = FakeBackend::loadFixture("laptopLidOpenAndTwoExternal.json");
+    QVERIFY(config);
+
+    auto const data = Snapshot::serialize(config, 7);
+    Snapshot::View const view(data.constData(), data.size());
+    QVERIFY(view.isValid());
+    QCOMPARE(view.generation(), uint64_t(7));
+    QCOMPARE(view.fingerprint(), Fingerprint::config(config));
+    QCOMPARE(view.outputCount(), int(config->outputs().size()));
+
+    for (auto const& [id, output] : config->outputs()) {
+        auto const record = view.outputById(id);
+        QVERIFY(record);
+        QCOMPARE(bool(record->flags & Snapshot::Enabled), output->enabled());
+        QCOMPARE(record->type, int32_t(output->type()));
+        QCOMPARE(view.string(record->name), std::string_view(output->name()));
+        QCOMPARE(view.string(record->hash), std::string_view(output->hash()));
+        QCOMPARE(view.qstring(record->description),
+                 QString::fromStdString(output->description()));
+        QCOMPARE(view.geometry(*record), output->geometry());
+        QCOMPARE(record->scale, output->scale());
+        if (auto const mode = output->auto_mode()) {
+            QCOMPARE(view.modeSize(*record), mode->size());
+            QCOMPARE(view.string(record->modeId), std::string_view(mode->id()));
+        }
+    }
+    QVERIFY(!view.outputById(-1));
+}
+
+void TestSnapshot::empty()
+{
+    auto const data = Snapshot::serialize(nullptr, 1);
+    Snapshot::View const view(data.constData(), data.size());
+    QVERIFY(view.isValid());
+    QCOMPARE(view.outputCount(), 0);
+    QCOMPARE(view.fingerprint(), uint64_t(0));
+}
+
+void TestSnapshot::invalid()
+{
+    auto const config = FakeBackend::loadFixture("laptopAndExternal.json");
+    QVERIFY(config);
+    auto const data = Snapshot::serialize(config, 1);
+
+    QVERIFY(!Snapshot::View().isValid());
+    QVERIFY(!Snapshot::View(data.constData(), data.size() - 1).isValid());
+    QVERIFY(!Snapshot::View(data.constData(), sizeof(Snapshot::Header) - 1).isValid());
+
+    auto wrongVersion = data;
+    reinterpret_cast<Snapshot::Header*>(wrongVersion.data())->version = Snapshot::version + 1;
+    QVERIFY(!Snapshot::View(wrongVersion.constData(), wrongVersion.size()).isValid());
+
+    // A string running past the end.
+    auto outOfBounds = data;
+    auto const records
+        = reinterpret_cast<Snapshot::Output*>(outOfBounds.data() + sizeof(Snapshot::Header));
+    records[0].name.length = outOfBounds.size();
+    QVERIFY(!Snapshot::View(outOfBounds.constData(), outOfBounds.size()).isValid());
+}
+
+void TestSnapshot::sealedFd()
+{
+    auto const config = FakeBackend::loadFixture("laptopAndExternal.json");
+    QVERIFY(config);
+    auto const data = Snapshot::serialize(config, 3);
+
+    auto const fd = Snapshot::createSealedFd(data);
+    QVERIFY(fd >= 0);
+
+    // Readers can rely on the content not changing under them.
+    QCOMPARE(write(fd, "x", 1), ssize_t(-1));
+    QCOMPARE(ftruncate(fd, 0), -1);
+    QCOMPARE(fcntl(fd, F_GET_SEALS) & F_SEAL_WRITE, F_SEAL_WRITE);
+
+    Snapshot::Mapping mapping(fd);
+    close(fd);
+    QVERIFY(mapping.view().isValid());
+    QCOMPARE(mapping.view().generation(), uint64_t(3));
+    QCOMPARE(mapping.view().outputCount(), int(config->outputs().size()));
+
+    auto moved = std::move(mapping);
+    QVERIFY(!mapping.view().isValid());
+    QCOMPARE(moved.view().fingerprint(), Fingerprint::config(config));
+
+    // Not mapped when the content could still change.
+    auto const unsealed = memfd_create("kdisplay-test", MFD_CLOEXEC);
+    QVERIFY(unsealed >= 0);
+    QCOMPARE(write(unsealed, data.constData(), data.size()), ssize_t(data.size()));
+    QVERIFY(!Snapshot::Mapping(unsealed).view().isValid());
+    close(unsealed);
+
+    // Neither is a regular file, which can't be sealed.
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), qint64(data.size()));
+    QVERIFY(file.flush());
+    QVERIFY(!Snapshot::Mapping(file.handle()).view().isValid());
+}
+
+QTEST_GUILESS_MAIN(TestSnapshot)
+
+#include "testsnapshot.moc"
+#include "fake_backend.h"
@@ -0,0 +1,235 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "configgen.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QSize>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+namespace ConfigGen
+{
+
+// Together these give max_modes distinct modes.
+static constexpr std::array<QSize, 20> resolutions{{
+    {640, 480},   {800, 600},   {1024, 768},  {1152, 864},  {1280, 720},
+    {1280, 800},  {1280, 1024}, {1366, 768},  {1440, 900},  {1600, 900},
+    {1600, 1200}, {1680, 1050}, {1920, 1080}, {1920, 1200}, {2560, 1080},
+    {2560, 1440}, {2560, 1600}, {3440, 1440}, {3840, 2160}, {5120, 2880},
+}};
+static constexpr std::array<double, 25> refreshRates{
+    23.976, 24,  25,  29.97, 30,  47.952, 48,  50,  59.94, 59.95, 60,  72,  75,
+    84.99,  90,  100, 119.88, 120, 143.98, 144, 165, 170,  180,   240, 360,
+};
+static_assert(resolutions.size() * refreshRates.size() == max_modes);
+
+// Disman::Output::Rotation
+static constexpr std::array<int, 4> rotations{1, 2, 4, 8};
+static constexpr std::array<double, 5> scales{1., 1.25, 1.5, 1.75, 2.};
+
+struct Connector {
+    char const* type;
+    char const* name;
+};
+static constexpr Connector panel{"LVDS", "eDP"};
+static constexpr std::array<Connector, 4> externals{{
+    {"HDMI", "HDMI-A"},
+    {"DisplayPort", "DP"},
+    {"DVI", "DVI-D"},
+    {"VGA", "VGA"},
+}};
+
+static QJsonObject size(QSize const& size)
+{
+    return {{QStringLiteral("width"), size.width()}, {QStringLiteral("height"), size.height()}};
+}
+
+static QJsonObject point(int x, int y)
+{
+    return {{QStringLiteral("x"), x}, {QStringLiteral("y"), y}};
+}
+
+struct Mode {
+    int id;
+    QSize size;
+    double refresh;
+};
+
+static std::vector<Mode> modes(int count, QRandomGenerator& random)
+{
+    std::vector<int> combinations(max_modes);
+    std::iota(combinations.begin(), combinations.end(), 0);
+    for (int i = 0; i < count; i++) {
+        std::swap(combinations[i], combinations[i + random.bounded(max_modes - i)]);
+    }
+    combinations.resize(count);
+
+    // Largest and fastest first, like backends list them.
+    std::vector<Mode> modes;
+    for (auto const combination : combinations) {
+        modes.push_back({0,
+                         resolutions[combination / refreshRates.size()],
+                         refreshRates[combination % refreshRates.size()]});
+    }
+    std::sort(modes.begin(), modes.end(), [](auto const& lhs, auto const& rhs) {
+        auto const lhsArea = lhs.size.width() * lhs.size.height();
+        auto const rhsArea = rhs.size.width() * rhs.size.height();
+        if (lhsArea != rhsArea) {
+            return lhsArea > rhsArea;
+        }
+        return lhs.refresh > rhs.refresh;
+    });
+    for (size_t i = 0; i < modes.size(); i++) {
+        modes[i].id = static_cast<int>(i) + 1;
+    }
+    return modes;
+}
+
+static Mode const& preferredMode(std::vector<Mode> const& modes)
+{
+    // The largest resolution at the rate closest to 60 Hz.
+    auto preferred = modes.cbegin();
+    for (auto it = modes.cbegin(); it != modes.cend() && it->size == modes.front().size; it++) {
+        if (std::abs(it->refresh - 60) < std::abs(preferred->refresh - 60)) {
+            preferred = it;
+        }
+    }
+    return *preferred;
+}
+
+Options normalized(Options options)
+{
+    options.outputs = std::clamp(options.outputs, min_outputs, max_outputs);
+    options.modesPerOutput = std::clamp(options.modesPerOutput, min_modes, max_modes);
+    options.panels = std::clamp(options.panels, 0, options.outputs);
+    options.disabledPercent = std::clamp(options.disabledPercent, 0, 100);
+    options.replicationPercent = std::clamp(options.replicationPercent, 0, 100);
+    return options;
+}
+
+QJsonObject generate(Options const& unnormalized)
+{
+    auto const options = normalized(unnormalized);
+    QRandomGenerator random(options.seed);
+
+    QJsonArray outputs;
+    std::vector<QJsonObject> sources;
+    bool anyEnabled = false;
+    std::array<int, externals.size()> connectorCount{};
+    int x = 0;
+    int height = 0;
+
+    for (int i = 0; i < options.outputs; i++) {
+        auto const id = i + 1;
+        auto const isPanel = i < options.panels;
+
+        auto const connectorIndex = isPanel ? 0 : random.bounded(int(externals.size()));
+        auto const& connector = isPanel ? panel : externals[connectorIndex];
+        auto const connectorNumber = isPanel ? i + 1 : ++connectorCount[connectorIndex];
+
+        auto const outputModes = modes(options.modesPerOutput, random);
+        auto const& preferred = preferredMode(outputModes);
+
+        QJsonArray modesJson;
+        for (auto const& mode : outputModes) {
+            modesJson.append(QJsonObject{
+                {QStringLiteral("id"), mode.id},
+                {QStringLiteral("name"),
+                 QStringLiteral("%1x%2@%3")
+                     .arg(mode.size.width())
+                     .arg(mode.size.height())
+                     .arg(mode.refresh)},
+                {QStringLiteral("refreshRate"), mode.refresh},
+                {QStringLiteral("size"), size(mode.size)},
+            });
+        }
+
+        // Keep at least one output enabled.
+        auto const isEnabled = isPanel || (!anyEnabled && i == options.outputs - 1)
+            || int(random.bounded(100)) >= options.disabledPercent;
+
+        auto const rotation = options.rotations ? rotations[random.bounded(int(rotations.size()))]
+                                                : rotations.front();
+        auto const scale
+            = options.scales ? scales[random.bounded(int(scales.size()))] : scales.front();
+
+        QJsonObject output{
+            {QStringLiteral("id"), id},
+            {QStringLiteral("name"),
+             QStringLiteral("%1-%2").arg(QLatin1String(connector.name)).arg(connectorNumber)},
+            {QStringLiteral("type"), QLatin1String(connector.type)},
+            {QStringLiteral("modes"), modesJson},
+            {QStringLiteral("preferredModes"), QJsonArray{preferred.id}},
+            {QStringLiteral("rotation"), rotation},
+            {QStringLiteral("scale"), scale},
+            {QStringLiteral("connected"), true},
+            {QStringLiteral("enabled"), isEnabled},
+            {QStringLiteral("primary"), false},
+        };
+
+        if (!isEnabled) {
+            output[QStringLiteral("pos")] = point(x, 0);
+            outputs.append(output);
+            continue;
+        }
+        output[QStringLiteral("currentModeId")] = preferred.id;
+
+        if (!isPanel && !sources.empty() && int(random.bounded(100)) < options.replicationPercent) {
+            // Replicate an earlier output and share its position.
+            auto const& source = sources[random.bounded(int(sources.size()))];
+            output[QStringLiteral("replicationSource")] = source[QStringLiteral("id")];
+            output[QStringLiteral("pos")] = source[QStringLiteral("pos")];
+        } else {
+            // Laid out left to right by logical size.
+            auto logical = QSizeF(preferred.size) / scale;
+            if (rotation == 2 || rotation == 8) {
+                logical.transpose();
+            }
+            output[QStringLiteral("pos")] = point(x, 0);
+            x += std::lround(logical.width());
+            height = std::max<int>(height, std::lround(logical.height()));
+            sources.push_back(output);
+        }
+
+        if (!anyEnabled) {
+            output[QStringLiteral("primary")] = true;
+            anyEnabled = true;
+        }
+        outputs.append(output);
+    }
+
+    QJsonObject screen{
+        {QStringLiteral("id"), 1},
+        {QStringLiteral("minSize"), size({320, 200})},
+        {QStringLiteral("maxSize"), size({std::max(x, 8192), std::max(height, 8192)})},
+        {QStringLiteral("currentSize"), size({x, height})},
+        {QStringLiteral("maxActiveOutputsCount"), options.outputs},
+    };
+    return {{QStringLiteral("screen"), screen}, {QStringLiteral("outputs"), outputs}};
+}
+
+QByteArray generateJson(Options const& options)
+{
+    return QJsonDocument(generate(options)).toJson(QJsonDocument::Indented);
+}
+
+bool write(Options const& options, QString const& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    auto const json = generateJson(options);
+    return file.write(json) == json.size();
+}
+
+}
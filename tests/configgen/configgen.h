@@ -0,0 +1,56 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * Generates configs in the JSON format of the Disman fake backend, so tests and benchmarks can
+ * run on many outputs and modes without hand-written fixtures. The same options and seed always
+ * result in the same config.
+ */
+namespace ConfigGen
+{
+
+static constexpr int min_outputs = 1;
+static constexpr int max_outputs = 32;
+static constexpr int min_modes = 1;
+static constexpr int max_modes = 500;
+
+struct Options {
+    int outputs{2};
+    int modesPerOutput{10};
+    uint32_t seed{0};
+
+    /// The first outputs are built-in panels, the others are external.
+    int panels{1};
+
+    /// Probability in percent for an external output to be connected but disabled.
+    int disabledPercent{20};
+
+    /// Probability in percent for an enabled external output to replicate an earlier one.
+    int replicationPercent{0};
+
+    bool rotations{false};
+    bool scales{false};
+};
+
+/**
+ * Clamps the options to the supported ranges.
+ */
+Options normalized(Options options);
+
+QJsonObject generate(Options const& options);
+QByteArray generateJson(Options const& options);
+
+/**
+ * Writes the generated config to @p path. Point DISMAN_BACKEND_ARGS at it with TEST_DATA=path.
+ */
+bool write(Options const& options, QString const& path);
+
+}
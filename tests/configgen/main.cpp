@@ -0,0 +1,83 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "configgen.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        QStringLiteral("Generates configs for the Disman fake backend. The same options and seed "
+                       "always generate the same config."));
+    parser.addHelpOption();
+
+    QCommandLineOption outputs(
+        QStringLiteral("outputs"),
+        QStringLiteral("Number of outputs (%1 to %2).")
+            .arg(ConfigGen::min_outputs)
+            .arg(ConfigGen::max_outputs),
+        QStringLiteral("count"),
+        QStringLiteral("2"));
+    QCommandLineOption modes(QStringLiteral("modes"),
+                             QStringLiteral("Number of modes per output (%1 to %2).")
+                                 .arg(ConfigGen::min_modes)
+                                 .arg(ConfigGen::max_modes),
+                             QStringLiteral("count"),
+                             QStringLiteral("10"));
+    QCommandLineOption seed(QStringLiteral("seed"),
+                            QStringLiteral("Seed of the random generator."),
+                            QStringLiteral("seed"),
+                            QStringLiteral("0"));
+    QCommandLineOption panels(QStringLiteral("panels"),
+                              QStringLiteral("Number of built-in panels."),
+                              QStringLiteral("count"),
+                              QStringLiteral("1"));
+    QCommandLineOption disabled(QStringLiteral("disabled"),
+                                QStringLiteral("Chance in percent for an external output to be "
+                                               "disabled."),
+                                QStringLiteral("percent"),
+                                QStringLiteral("20"));
+    QCommandLineOption replication(QStringLiteral("replication"),
+                                   QStringLiteral("Chance in percent for an external output to "
+                                                  "replicate an earlier one."),
+                                   QStringLiteral("percent"),
+                                   QStringLiteral("0"));
+    QCommandLineOption rotations(QStringLiteral("rotations"),
+                                 QStringLiteral("Rotate outputs randomly."));
+    QCommandLineOption scales(QStringLiteral("scales"), QStringLiteral("Scale outputs randomly."));
+    QCommandLineOption output({QStringLiteral("o"), QStringLiteral("output")},
+                              QStringLiteral("Write to this file instead of stdout."),
+                              QStringLiteral("file"));
+    parser.addOptions(
+        {outputs, modes, seed, panels, disabled, replication, rotations, scales, output});
+    parser.process(app);
+
+    ConfigGen::Options options;
+    options.outputs = parser.value(outputs).toInt();
+    options.modesPerOutput = parser.value(modes).toInt();
+    options.seed = parser.value(seed).toUInt();
+    options.panels = parser.value(panels).toInt();
+    options.disabledPercent = parser.value(disabled).toInt();
+    options.replicationPercent = parser.value(replication).toInt();
+    options.rotations = parser.isSet(rotations);
+    options.scales = parser.isSet(scales);
+
+    if (parser.isSet(output)) {
+        if (!ConfigGen::write(options, parser.value(output))) {
+            QTextStream(stderr) << "Could not write " << parser.value(output) << Qt::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    QTextStream(stdout) << ConfigGen::generateJson(options);
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "configgen.h"
+#include "fake_backend.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+#include <disman/output.h>
+
+#include <QJsonArray>
+#include <QObject>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QtTest>
+
+class TestConfigGen : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void reproducible();
+    void bounds_data();
+    void bounds();
+    void replication();
+    void loads_data();
+    void loads();
+};
+
+void TestConfigGen::initTestCase()
+{
+    qputenv("DISMAN_IN_PROCESS", "1");
+    qputenv("DISMAN_LOGGING", "false");
+    qputenv("DISMAN_BACKEND", "fake");
+}
+
+void TestConfigGen::cleanupTestCase()
+{
+    Disman::BackendManager::instance()->shutdown_backend();
+}
+
+void TestConfigGen::reproducible()
+{
+    ConfigGen::Options options;
+    options.outputs = 8;
+    options.modesPerOutput = 50;
+    options.rotations = true;
+    options.scales = true;
+    options.replicationPercent = 30;
+    options.seed = 42;
+
+    auto const json = ConfigGen::generateJson(options);
+    QCOMPARE(ConfigGen::generateJson(options), json);
+
+    options.seed = 43;
+    QVERIFY(ConfigGen::generateJson(options) != json);
+}
+
+void TestConfigGen::bounds_data()
+{
+    QTest::addColumn<int>("outputs");
+    QTest::addColumn<int>("modes");
+    QTest::addColumn<int>("expectedOutputs");
+    QTest::addColumn<int>("expectedModes");
+
+    QTest::newRow("smallest") << 1 << 10 << 1 << 10;
+    QTest::newRow("largest") << 32 << 500 << 32 << 500;
+    QTest::newRow("clamped") << 100 << 1000 << ConfigGen::max_outputs << ConfigGen::max_modes;
+}
+
+void TestConfigGen::bounds()
+{
+    QFETCH(int, outputs);
+    QFETCH(int, modes);
+    QFETCH(int, expectedOutputs);
+    QFETCH(int, expectedModes);
+
+    ConfigGen::Options options;
+    options.outputs = outputs;
+    options.modesPerOutput = modes;
+    options.disabledPercent = 50;
+
+    auto const generated = ConfigGen::generate(options)[QStringLiteral("outputs")].toArray();
+    QCOMPARE(generated.size(), qsizetype(expectedOutputs));
+
+    bool enabled = false;
+    for (auto const& value : generated) {
+        auto const output = value.toObject();
+        enabled |= output[QStringLiteral("enabled")].toBool();
+
+        // Modes are distinct.
+        QSet<QString> names;
+        for (auto const& mode : output[QStringLiteral("modes")].toArray()) {
+            names.insert(mode.toObject()[QStringLiteral("name")].toString());
+        }
+        QCOMPARE(names.size(), qsizetype(expectedModes));
+    }
+    QVERIFY(enabled);
+}
+
+void TestConfigGen::replication()
+{
+    ConfigGen::Options options;
+    options.outputs = 4;
+    options.disabledPercent = 0;
+    options.replicationPercent = 100;
+
+    auto const generated = ConfigGen::generate(options)[QStringLiteral("outputs")].toArray();
+
+    // The panel is the only source, the external outputs replicate it at its position.
+    auto const panel = generated.first().toObject();
+    QVERIFY(!panel.contains(QStringLiteral("replicationSource")));
+    for (int i = 1; i < generated.size(); i++) {
+        auto const output = generated.at(i).toObject();
+        QCOMPARE(output[QStringLiteral("replicationSource")], panel[QStringLiteral("id")]);
+        QCOMPARE(output[QStringLiteral("pos")], panel[QStringLiteral("pos")]);
+    }
+}
+
+void TestConfigGen::loads_data()
+{
+    QTest::addColumn<int>("outputs");
+    QTest::addColumn<int>("modes");
+
+    QTest::newRow("1 output, 10 modes") << 1 << 10;
+    QTest::newRow("4 outputs, 100 modes") << 4 << 100;
+    QTest::newRow("32 outputs, 500 modes") << 32 << 500;
+}
+
+void TestConfigGen::loads()
+{
+    QFETCH(int, outputs);
+    QFETCH(int, modes);
+
+    ConfigGen::Options options;
+    options.outputs = outputs;
+    options.modesPerOutput = modes;
+    options.rotations = true;
+    options.scales = true;
+    options.seed = outputs * modes;
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto const path = dir.filePath(QStringLiteral("config.json"));
+    QVERIFY(ConfigGen::write(options, path));
+
+    auto const config = FakeBackend::load(path);
+    QVERIFY(config);
+
+    auto const generated = ConfigGen::generate(options)[QStringLiteral("outputs")].toArray();
+    QCOMPARE(config->outputs().size(), size_t(outputs));
+    for (auto const& value : generated) {
+        auto const json = value.toObject();
+        auto const output = config->outputs().at(json[QStringLiteral("id")].toInt());
+        QCOMPARE(QString::fromStdString(output->name()), json[QStringLiteral("name")].toString());
+        QCOMPARE(output->enabled(), json[QStringLiteral("enabled")].toBool());
+        QCOMPARE(output->modes().size(), size_t(modes));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestConfigGen)
+
+#include "testconfiggen.moc"
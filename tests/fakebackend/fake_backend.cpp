@@ -0,0 +1,45 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "fake_backend.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+#include <disman/getconfigoperation.h>
+
+#include <QDebug>
+
+namespace FakeBackend
+{
+
+QString fixture(QByteArray const& fileName)
+{
+    return QStringLiteral(FIXTURES_DIR) + QString::fromUtf8(fileName);
+}
+
+void select(QString const& path)
+{
+    Disman::BackendManager::instance()->shutdown_backend();
+    qputenv("DISMAN_BACKEND_ARGS", "TEST_DATA=" + path.toUtf8());
+}
+
+Disman::ConfigPtr load(QString const& path)
+{
+    select(path);
+
+    auto op = new Disman::GetConfigOperation;
+    if (!op->exec()) {
+        qWarning() << op->error_string();
+        return nullptr;
+    }
+    return op->config();
+}
+
+Disman::ConfigPtr loadFixture(QByteArray const& fileName)
+{
+    return load(fixture(fileName));
+}
+
+}
@@ -0,0 +1,40 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <disman/types.h>
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * Switches the in-process fake backend between configs. The backend must be selected with
+ * DISMAN_BACKEND=fake and DISMAN_IN_PROCESS=1.
+ */
+namespace FakeBackend
+{
+
+/**
+ * The path of @p fileName in tests/kded/configs.
+ */
+QString fixture(QByteArray const& fileName);
+
+/**
+ * Restarts the backend on the config in @p path. The next fetch gets that config.
+ */
+void select(QString const& path);
+
+/**
+ * Selects @p path and fetches its config, null when that failed.
+ */
+Disman::ConfigPtr load(QString const& path);
+
+/**
+ * Like load() for one of the fixtures.
+ */
+Disman::ConfigPtr loadFixture(QByteArray const& fileName);
+
+}
@@ -0,0 +1,174 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../common/fingerprint.h"
+#include "../../common/utils.h"
+#include "../../kcm/config_cache.h"
+#include "../../kcm/config_handler.h"
+#include "../../kcm/output_model.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+#include <disman/output.h>
+
+#include <QFile>
+#include <QObject>
+#include <QPointer>
+#include <QtTest>
+
+using namespace Disman;
+
+class TestConfigCache : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void roundTrip();
+    void invalidCache();
+    void reconcile();
+    void reconcileOtherOutputs();
+};
+
+void TestConfigCache::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestConfigCache::init()
+{
+    QFile::remove(ConfigCache::path());
+}
+
+void TestConfigCache::cleanupTestCase()
+{
+    QFile::remove(ConfigCache::path());
+    BackendManager::instance()->shutdown_backend();
+}
+
+void TestConfigCache::roundTrip()
+{
+    QVERIFY(!ConfigCache::load());
+
+    auto const config = FakeBackend::loadFixture("laptopLidOpenAndTwoExternal.json");
+    QVERIFY(config);
+    ConfigCache::store(config);
+    QVERIFY(QFile::exists(ConfigCache::path()));
+
+    auto const cached = ConfigCache::load();
+    QVERIFY(cached);
+    QCOMPARE(cached->outputs().size(), config->outputs().size());
+    QCOMPARE(Fingerprint::config(cached), Fingerprint::config(config));
+
+    for (auto const& [id, output] : config->outputs()) {
+        auto const copy = cached->outputs().at(id);
+        QCOMPARE(copy->hash(), output->hash());
+        QCOMPARE(copy->name(), output->name());
+        QCOMPARE(copy->type(), output->type());
+        QCOMPARE(copy->enabled(), output->enabled());
+        if (output->enabled()) {
+            QCOMPARE(copy->geometry(), output->geometry());
+        }
+    }
+}
+
+void TestConfigCache::invalidCache()
+{
+    QFile file(ConfigCache::path());
+    QVERIFY(QDir().mkpath(QFileInfo(file).absolutePath()));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a snapshot, but long enough to hold a header");
+    file.close();
+
+    QVERIFY(!ConfigCache::load());
+}
+
+void TestConfigCache::reconcile()
+{
+    auto const config = FakeBackend::loadFixture("laptopLidOpenAndTwoExternal.json");
+    QVERIFY(config);
+    ConfigCache::store(config);
+
+    ConfigHandler handler;
+    handler.setPreview(ConfigCache::load());
+    QVERIFY(handler.isPreview());
+    auto const model = handler.outputModel();
+    QVERIFY(model);
+    QCOMPARE(model->rowCount(), int(config->outputs().size()));
+
+    // Since the cache was written an enabled output moved.
+    auto const live = FakeBackend::loadFixture("laptopLidOpenAndTwoExternal.json");
+    QVERIFY(live);
+    OutputPtr moved;
+    for (auto const& [id, output] : live->outputs()) {
+        if (output->enabled()) {
+            moved = output;
+        }
+    }
+    QVERIFY(moved);
+    moved->set_position(moved->position() + QPointF(0, 100));
+
+    QSignalSpy modelSpy(&handler, &ConfigHandler::outputModelChanged);
+    QSignalSpy insertSpy(model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy dataSpy(model, &QAbstractItemModel::dataChanged);
+
+    handler.setConfig(live);
+    QVERIFY(!handler.isPreview());
+    QCOMPARE(handler.outputModel(), model);
+    QCOMPARE(modelSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), 0);
+    QCOMPARE(removeSpy.count(), 0);
+
+    // Every role of the moved row, only the derived roles of the others.
+    int fullRows = 0;
+    for (auto const& arguments : dataSpy) {
+        auto const index = arguments.at(0).toModelIndex();
+        auto const roles = arguments.at(2).value<QList<int>>();
+        if (roles.isEmpty()) {
+            fullRows++;
+            QCOMPARE(model->data(index, Qt::DisplayRole).toString(), Utils::outputName(moved));
+        } else {
+            QVERIFY(!roles.contains(OutputModel::PositionRole));
+        }
+    }
+    QCOMPARE(fullRows, 1);
+
+    // The rows now show the fetched outputs.
+    for (int row = 0; row < model->rowCount(); row++) {
+        auto const resolutions
+            = model->data(model->index(row), OutputModel::ResolutionsRole).toList();
+        QVERIFY(!resolutions.isEmpty());
+    }
+}
+
+void TestConfigCache::reconcileOtherOutputs()
+{
+    auto const config = FakeBackend::loadFixture("laptopLidOpenAndTwoExternal.json");
+    QVERIFY(config);
+    ConfigCache::store(config);
+
+    ConfigHandler handler;
+    handler.setPreview(ConfigCache::load());
+    QPointer<OutputModel> const preview = handler.outputModel();
+
+    // Something else is connected now, so the model is replaced.
+    QSignalSpy modelSpy(&handler, &ConfigHandler::outputModelChanged);
+    auto const live = FakeBackend::loadFixture("laptopAndExternal.json");
+    QVERIFY(live);
+    handler.setConfig(live);
+    QCOMPARE(modelSpy.count(), 1);
+    QVERIFY(handler.outputModel() != preview);
+    QCOMPARE(handler.outputModel()->rowCount(), int(live->outputs().size()));
+    QTRY_VERIFY(!preview);
+}
+
+QTEST_MAIN(TestConfigCache)
+
+#include "testconfigcache.moc"
+#include "fake_backend.h"
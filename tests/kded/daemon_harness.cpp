@@ -0,0 +1,349 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "daemon_harness.h"
+
+#include "../../plasma-integration/kded/daemon.h"
+#include "../../plasma-integration/kded/profiles.h"
+#include "fake_backend.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QFile>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTest>
+
+static QString const osdService = QStringLiteral("org.kwinft.kdisplay.osdService");
+static QString const osdPath = QStringLiteral("/org/kwinft/kdisplay/osdService");
+static QString const upowerService = QStringLiteral("org.freedesktop.UPower");
+static QString const upowerPath = QStringLiteral("/org/freedesktop/UPower");
+
+FakeOsdService::~FakeOsdService()
+{
+    if (m_registered) {
+        auto bus = QDBusConnection::sessionBus();
+        bus.unregisterObject(osdPath);
+        bus.unregisterService(osdService);
+    }
+}
+
+bool FakeOsdService::registerOnBus()
+{
+    auto bus = QDBusConnection::sessionBus();
+    if (!bus.isConnected()) {
+        return false;
+    }
+    if (!bus.registerObject(osdPath, this, QDBusConnection::ExportAllSlots)) {
+        return false;
+    }
+    if (!bus.registerService(osdService)) {
+        bus.unregisterObject(osdPath);
+        return false;
+    }
+    m_registered = true;
+    return true;
+}
+
+void FakeOsdService::hideOsd()
+{
+    hides++;
+}
+
+void FakeOsdService::prepare()
+{
+    prepares++;
+}
+
+void FakeOsdService::setProfiles(QStringList const& profiles)
+{
+    this->profiles = profiles;
+}
+
+int FakeOsdService::showActionSelector(int& profile)
+{
+    requests++;
+    lastOutputName.clear();
+    lastGeometry = QRect();
+    profile = answerProfile;
+    return answer;
+}
+
+int FakeOsdService::showActionSelectorOn(QString const& outputName,
+                                         QRect const& geometry,
+                                         int& profile)
+{
+    requests++;
+    lastOutputName = outputName;
+    lastGeometry = geometry;
+    profile = answerProfile;
+    return answer;
+}
+
+FakeUPower::~FakeUPower()
+{
+    if (m_registered) {
+        auto bus = QDBusConnection::sessionBus();
+        bus.unregisterObject(upowerPath);
+        bus.unregisterService(upowerService);
+    }
+}
+
+bool FakeUPower::registerOnBus()
+{
+    auto bus = QDBusConnection::sessionBus();
+    if (!bus.isConnected()) {
+        return false;
+    }
+    if (!bus.registerObject(upowerPath, this, QDBusConnection::ExportAllProperties)) {
+        return false;
+    }
+    if (!bus.registerService(upowerService)) {
+        bus.unregisterObject(upowerPath);
+        return false;
+    }
+    m_registered = true;
+    return true;
+}
+
+bool FakeUPower::lidIsPresent() const
+{
+    return m_lidPresent;
+}
+
+bool FakeUPower::lidIsClosed() const
+{
+    return m_lidClosed;
+}
+
+bool FakeUPower::onBattery() const
+{
+    return m_onBattery;
+}
+
+void FakeUPower::setLidPresent(bool present)
+{
+    m_lidPresent = present;
+    notify(QStringLiteral("LidIsPresent"), present);
+}
+
+void FakeUPower::setLidClosed(bool closed)
+{
+    m_lidClosed = closed;
+    notify(QStringLiteral("LidIsClosed"), closed);
+}
+
+void FakeUPower::setOnBattery(bool onBattery)
+{
+    m_onBattery = onBattery;
+    notify(QStringLiteral("OnBattery"), onBattery);
+}
+
+void FakeUPower::notify(QString const& name, QVariant const& value)
+{
+    if (!m_registered) {
+        return;
+    }
+    auto message = QDBusMessage::createSignal(upowerPath,
+                                              QStringLiteral("org.freedesktop.DBus.Properties"),
+                                              QStringLiteral("PropertiesChanged"));
+    message << upowerService << QVariantMap{{name, value}} << QStringList();
+    QDBusConnection::sessionBus().send(message);
+}
+
+QOrientationReading::Orientation FakeOrientationSensor::value() const
+{
+    return m_reading;
+}
+
+bool FakeOrientationSensor::available() const
+{
+    return m_available;
+}
+
+bool FakeOrientationSensor::enabled() const
+{
+    return m_enabled;
+}
+
+void FakeOrientationSensor::setEnabled(bool enable)
+{
+    if (m_enabled == enable) {
+        return;
+    }
+    m_enabled = enable;
+    Q_EMIT enabledChanged(enable);
+}
+
+void FakeOrientationSensor::setReading(QOrientationReading::Orientation orientation)
+{
+    if (!m_available) {
+        m_available = true;
+        Q_EMIT availableChanged(true);
+    }
+    if (m_reading != orientation) {
+        m_reading = orientation;
+        Q_EMIT valueChanged(orientation);
+    }
+}
+
+static QProcess* s_bus = nullptr;
+
+static void stopPrivateBus()
+{
+    s_bus->terminate();
+    s_bus->waitForFinished();
+    delete s_bus;
+    s_bus = nullptr;
+}
+
+static QString startPrivateBus()
+{
+    if (s_bus) {
+        return {};
+    }
+
+    s_bus = new QProcess;
+    s_bus->start(QStringLiteral("dbus-daemon"),
+                 {QStringLiteral("--session"),
+                  QStringLiteral("--nofork"),
+                  QStringLiteral("--print-address")});
+    if (!s_bus->waitForStarted() || !s_bus->waitForReadyRead()) {
+        delete s_bus;
+        s_bus = nullptr;
+        return QStringLiteral("Cannot start a private session bus");
+    }
+    qputenv("DBUS_SESSION_BUS_ADDRESS", s_bus->readLine().trimmed());
+    qAddPostRoutine(stopPrivateBus);
+
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        return QStringLiteral("Cannot connect to the private session bus");
+    }
+    return {};
+}
+
+DaemonHarness::DaemonHarness()
+{
+    qputenv("DISMAN_IN_PROCESS", "1");
+    qputenv("DISMAN_LOGGING", "false");
+    qputenv("DISMAN_BACKEND", "fake");
+
+    // The daemon reads its profiles and lowered rates from disk, every test starts without any.
+    QStandardPaths::setTestModeEnabled(true);
+    QFile::remove(ProfileStore::defaultPath());
+    auto power
+        = KSharedConfig::openConfig(QStringLiteral("kdisplayrc"))->group(QStringLiteral("Power"));
+    power.deleteEntry("LoweredOutputs");
+    power.sync();
+}
+
+DaemonHarness::~DaemonHarness()
+{
+    m_daemon.reset();
+    Disman::BackendManager::instance()->shutdown_backend();
+}
+
+bool DaemonHarness::start(QByteArray const& fixture)
+{
+    m_error = startPrivateBus();
+    if (!m_error.isEmpty()) {
+        return false;
+    }
+    // Only when something connected to the session bus of the session before the private one
+    // was started.
+    if (!m_osd.registerOnBus()) {
+        m_error = QStringLiteral("The OSD service is owned by another process");
+        return false;
+    }
+    if (!m_upower.registerOnBus()) {
+        m_error = QStringLiteral("The UPower service is owned by another process");
+        return false;
+    }
+
+    FakeBackend::select(FakeBackend::fixture(fixture));
+
+    // UPower is looked for on the private session bus, where the stand-in is.
+    m_orientationSensor = new FakeOrientationSensor;
+    m_daemon = std::make_unique<KDisplayDaemon>(
+        nullptr, m_orientationSensor, QDBusConnection::sessionBus());
+    return QTest::qWaitFor([this] { return m_daemon->monitoredConfig() != nullptr; });
+}
+
+bool DaemonHarness::hotplug(QByteArray const& fixture)
+{
+    auto config = FakeBackend::loadFixture(fixture);
+    if (!config) {
+        return false;
+    }
+    hotplug(config);
+    return true;
+}
+
+void DaemonHarness::hotplug(Disman::ConfigPtr const& config)
+{
+    // Without a stored layout the backend hands out a generated config on hotplug.
+    config->set_cause(Disman::Config::Cause::generated);
+    m_daemon->monitoredConfig()->set_cause(Disman::Config::Cause::generated);
+    m_daemon->monitoredConfig()->apply(config);
+}
+
+bool DaemonHarness::settle(int timeout)
+{
+    return QTest::qWaitFor(
+        [this] {
+            return counter(QStringLiteral("applies"))
+                == counter(QStringLiteral("finishedApplies"));
+        },
+        timeout);
+}
+
+QString DaemonHarness::error() const
+{
+    return m_error;
+}
+
+KDisplayDaemon* DaemonHarness::daemon() const
+{
+    return m_daemon.get();
+}
+
+Disman::ConfigPtr DaemonHarness::config() const
+{
+    return m_daemon->monitoredConfig();
+}
+
+FakeOrientationSensor* DaemonHarness::orientationSensor() const
+{
+    return m_orientationSensor;
+}
+
+FakeOsdService& DaemonHarness::osd()
+{
+    return m_osd;
+}
+
+FakeUPower& DaemonHarness::upower()
+{
+    return m_upower;
+}
+
+uint64_t DaemonHarness::counter(QString const& name) const
+{
+    auto const counters = m_daemon->statistics().toVariantMap()[QStringLiteral("counters")];
+    return counters.toMap()[name].toULongLong();
+}
+
+QVariantMap DaemonHarness::stage(QString const& name) const
+{
+    auto const stages = m_daemon->statistics().toVariantMap()[QStringLiteral("stages")];
+    return stages.toMap()[name].toMap();
+}
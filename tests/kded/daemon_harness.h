@@ -0,0 +1,169 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "../../common/orientation_sensor.h"
+#include "../../plasma-integration/osd/osdaction.h"
+
+#include <disman/types.h>
+
+#include <QByteArray>
+#include <QObject>
+#include <QRect>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+#include <memory>
+
+class KDisplayDaemon;
+
+/**
+ * Stand-in for the OSD service on the session bus. Answers every selector request right away
+ * with a preset action.
+ */
+class FakeOsdService : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kwinft.kdisplay.osdService")
+
+public:
+    ~FakeOsdService() override;
+
+    bool registerOnBus();
+
+    int answer = KDisplay::OsdAction::NoAction;
+    // The index of the profile to select or -1.
+    int answerProfile = -1;
+    int requests = 0;
+    int hides = 0;
+    int prepares = 0;
+    QString lastOutputName;
+    QRect lastGeometry;
+    QStringList profiles;
+
+public Q_SLOTS:
+    void hideOsd();
+    void prepare();
+    void setProfiles(QStringList const& profiles);
+    int showActionSelector(int& profile);
+    int showActionSelectorOn(QString const& outputName, QRect const& geometry, int& profile);
+
+private:
+    bool m_registered = false;
+};
+
+/**
+ * Stand-in for UPower on the session bus. Changes are announced with PropertiesChanged like
+ * UPower does.
+ */
+class FakeUPower : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.UPower")
+    Q_PROPERTY(bool LidIsPresent READ lidIsPresent)
+    Q_PROPERTY(bool LidIsClosed READ lidIsClosed)
+    Q_PROPERTY(bool OnBattery READ onBattery)
+
+public:
+    ~FakeUPower() override;
+
+    bool registerOnBus();
+
+    bool lidIsPresent() const;
+    bool lidIsClosed() const;
+    bool onBattery() const;
+    void setLidPresent(bool present);
+    void setLidClosed(bool closed);
+    void setOnBattery(bool onBattery);
+
+private:
+    void notify(QString const& name, QVariant const& value);
+
+    bool m_lidPresent = false;
+    bool m_lidClosed = false;
+    bool m_onBattery = false;
+    bool m_registered = false;
+};
+
+/**
+ * Stand-in for the orientation sensor. It becomes available with the first reading.
+ */
+class FakeOrientationSensor : public OrientationSensor
+{
+    Q_OBJECT
+
+public:
+    using OrientationSensor::OrientationSensor;
+
+    QOrientationReading::Orientation value() const override;
+    bool available() const override;
+    bool enabled() const override;
+    void setEnabled(bool enable) override;
+
+    void setReading(QOrientationReading::Orientation orientation);
+
+private:
+    QOrientationReading::Orientation m_reading = QOrientationReading::Undefined;
+    bool m_available = false;
+    bool m_enabled = false;
+};
+
+/**
+ * Runs the daemon in-process against the Disman fake backend. Hotplugs are scripted by
+ * switching between the JSON configs in tests/kded/configs.
+ *
+ * The stand-ins and the daemon talk over a private session bus, so they do not clash with a
+ * running session. It is started once per process and must be in place before anything else
+ * connects to the session bus.
+ */
+class DaemonHarness
+{
+public:
+    DaemonHarness();
+    ~DaemonHarness();
+
+    /**
+     * Registers the OSD and UPower stand-ins and starts the daemon on @p fixture. Returns false
+     * when that failed, error() tells why.
+     */
+    bool start(QByteArray const& fixture);
+    QString error() const;
+
+    /**
+     * Switches the fake backend to @p fixture and hands the new config to the daemon the way
+     * the config monitor does, which emits the output added and removed signals.
+     */
+    bool hotplug(QByteArray const& fixture);
+
+    /**
+     * Hands @p config to the daemon like a hotplug without touching the backend. Fast enough
+     * for many events in a row.
+     */
+    void hotplug(Disman::ConfigPtr const& config);
+
+    /**
+     * Waits until every SetConfigOperation the daemon started has finished.
+     */
+    bool settle(int timeout = 5000);
+
+    KDisplayDaemon* daemon() const;
+    Disman::ConfigPtr config() const;
+    FakeOrientationSensor* orientationSensor() const;
+    FakeOsdService& osd();
+    FakeUPower& upower();
+
+    uint64_t counter(QString const& name) const;
+    QVariantMap stage(QString const& name) const;
+
+private:
+    FakeOsdService m_osd;
+    FakeUPower m_upower;
+    std::unique_ptr<KDisplayDaemon> m_daemon;
+    // Owned by the daemon.
+    FakeOrientationSensor* m_orientationSensor = nullptr;
+    QString m_error;
+};
@@ -0,0 +1,496 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "daemon_harness.h"
+
+#include "../../common/fingerprint.h"
+#include "../../common/orientation_sensor.h"
+#include "../../common/snapshot.h"
+#include "../../plasma-integration/kded/daemon.h"
+#include "../../plasma-integration/kded/upower.h"
+
+#include <disman/config.h>
+#include <disman/mode.h>
+#include <disman/output.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Disman;
+
+// Upper bound for a single SetConfigOperation against the in-process fake backend. Far above what
+// it takes, but low enough to catch an apply that waits on a timeout.
+static constexpr qlonglong max_apply_usecs = 2'000'000;
+
+class TestDaemon : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void startup();
+    void hotplugSelectsLayout();
+    void hotplugCancelled();
+    void unplug();
+    void hotplugSequence();
+    void orientation();
+    void lid();
+    void lidWithoutExternal();
+    void lidClosedAtStart();
+    void hotplugWithLidClosed();
+    void battery();
+    void skipUnchanged();
+    void requestLayoutPreset();
+    void userBeforeSensor();
+    void profiles();
+    void snapshot();
+
+private:
+    void start(QByteArray const& fixture);
+
+    std::unique_ptr<DaemonHarness> m_harness;
+};
+
+void TestDaemon::init()
+{
+    m_harness = std::make_unique<DaemonHarness>();
+}
+
+void TestDaemon::cleanup()
+{
+    m_harness.reset();
+}
+
+void TestDaemon::start(QByteArray const& fixture)
+{
+    if (!m_harness->start(fixture)) {
+        QSKIP(qPrintable(m_harness->error()));
+    }
+}
+
+void TestDaemon::startup()
+{
+    start("laptopAndExternal.json");
+
+    // No OSD while starting up, but it gets prepared since there are multiple outputs.
+    QTRY_COMPARE(m_harness->osd().prepares, 1);
+    QCOMPARE(m_harness->osd().requests, 0);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 0u);
+
+    auto const daemon = m_harness->daemon();
+    QCOMPARE(daemon->property("connectedOutputCount").toInt(), 2);
+    QCOMPARE(daemon->property("enabledOutputCount").toInt(), 1);
+    QCOMPARE(daemon->property("layout").toString(), QStringLiteral("SwitchToInternal"));
+}
+
+void TestDaemon::hotplugSelectsLayout()
+{
+    start("singleOutput.json");
+    m_harness->osd().answer = KDisplay::OsdAction::ExtendRight;
+
+    QVERIFY(m_harness->hotplug("switchDisplayTwoScreens.json"));
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+    QVERIFY(m_harness->settle());
+
+    // The OSD is told where to show up.
+    QCOMPARE(m_harness->osd().requests, 1);
+    QCOMPARE(m_harness->osd().lastOutputName, QStringLiteral("LVDS1"));
+    QCOMPARE(m_harness->osd().lastGeometry, QRect(0, 0, 1280, 800));
+    auto const laptop = m_harness->config()->outputs().at(1);
+    auto const external = m_harness->config()->outputs().at(2);
+    QVERIFY(laptop->enabled());
+    QVERIFY(external->enabled());
+    QCOMPARE(laptop->position(), QPointF(0, 0));
+    QCOMPARE(external->position(), QPointF(1280, 0));
+
+    auto const daemon = m_harness->daemon();
+    QCOMPARE(daemon->property("connectedOutputCount").toInt(), 2);
+    QCOMPARE(daemon->property("enabledOutputCount").toInt(), 2);
+    QCOMPARE(daemon->property("layout").toString(), QStringLiteral("ExtendRight"));
+
+    auto const applied = m_harness->stage(QStringLiteral("hotplugToApplied"));
+    QCOMPARE(applied[QStringLiteral("count")].toULongLong(), 1u);
+
+    auto const apply = m_harness->stage(QStringLiteral("applyToApplied"));
+    QCOMPARE(apply[QStringLiteral("count")].toULongLong(), 1u);
+    QVERIFY(apply[QStringLiteral("max")].toLongLong() < max_apply_usecs);
+
+    // Measured from sending the request, not from the OSD showing up.
+    auto const osd = m_harness->stage(QStringLiteral("osdRequestToReply"));
+    QCOMPARE(osd[QStringLiteral("count")].toULongLong(), 1u);
+}
+
+void TestDaemon::hotplugCancelled()
+{
+    start("singleOutput.json");
+    m_harness->osd().answer = KDisplay::OsdAction::NoAction;
+
+    QVERIFY(m_harness->hotplug("switchDisplayTwoScreens.json"));
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("osdCancellations")), 1u);
+
+    QCOMPARE(m_harness->osd().requests, 1);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 0u);
+}
+
+void TestDaemon::unplug()
+{
+    start("switchDisplayTwoScreens.json");
+    QTRY_COMPARE(m_harness->osd().prepares, 1);
+    auto const hides = m_harness->osd().hides;
+
+    QVERIFY(m_harness->hotplug("singleOutput.json"));
+    QTRY_VERIFY(m_harness->osd().hides > hides);
+
+    QCOMPARE(m_harness->config()->outputs().size(), 1u);
+    QCOMPARE(m_harness->osd().requests, 0);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 0u);
+}
+
+void TestDaemon::hotplugSequence()
+{
+    start("singleOutput.json");
+    m_harness->osd().answer = KDisplay::OsdAction::Clone;
+
+    // Dock with one external output, the user picks cloning.
+    QVERIFY(m_harness->hotplug("switchDisplayTwoScreens.json"));
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+    QVERIFY(m_harness->settle());
+    QCOMPARE(m_harness->config()->outputs().at(2)->replication_source(), 1);
+
+    // A second external output. Layout presets only exist for two outputs, so nothing changes.
+    QVERIFY(m_harness->hotplug("laptopLidOpenAndTwoExternal.json"));
+    QTRY_COMPARE(m_harness->osd().requests, 2);
+    QVERIFY(m_harness->settle());
+    QCOMPARE(m_harness->config()->outputs().size(), 3u);
+
+    // Undock.
+    QVERIFY(m_harness->hotplug("singleOutput.json"));
+    QVERIFY(m_harness->settle());
+    QTRY_COMPARE(m_harness->config()->outputs().size(), 1u);
+    QVERIFY(m_harness->config()->outputs().at(1)->enabled());
+
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+    QCOMPARE(m_harness->counter(QStringLiteral("failedApplies")), 0u);
+    QVERIFY(m_harness->counter(QStringLiteral("hotplugs")) >= 3);
+}
+
+void TestDaemon::orientation()
+{
+    start("singleOutput.json");
+
+    auto config = m_harness->config();
+    config->set_supported_features(Config::Feature::AutoRotation | Config::Feature::TabletMode);
+    auto panel = config->outputs().at(1);
+    panel->set_auto_rotate_only_in_tablet_mode(false);
+
+    auto sensor = m_harness->orientationSensor();
+    sensor->setReading(QOrientationReading::TopUp);
+
+    m_harness->daemon()->setAutoRotate(true);
+    QVERIFY(m_harness->settle());
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+
+    sensor->setEnabled(true);
+    sensor->setReading(QOrientationReading::LeftUp);
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("applies")), 2u);
+    QVERIFY(m_harness->settle());
+
+    QCOMPARE(m_harness->counter(QStringLiteral("orientationApplies")), 1u);
+    QCOMPARE(panel->rotation(), Output::Rotation::Right);
+
+    // The sensor reporting the current orientation again, as after a wakeup, applies nothing.
+    sensor->setReading(QOrientationReading::FaceUp);
+    sensor->setReading(QOrientationReading::LeftUp);
+    QCOMPARE(m_harness->counter(QStringLiteral("skippedApplies")), 1u);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 2u);
+    QCOMPARE(m_harness->counter(QStringLiteral("orientationApplies")), 1u);
+}
+
+void TestDaemon::lid()
+{
+    m_harness->upower().setLidPresent(true);
+    start("laptopAndExternal.json");
+    QTRY_VERIFY(m_harness->daemon()->upower()->lidPresent());
+    QVERIFY(m_harness->settle());
+
+    auto const opened = Fingerprint::config(m_harness->config());
+    auto const applies = m_harness->counter(QStringLiteral("applies"));
+
+    // The panel goes off with the lid and the external output takes over.
+    m_harness->upower().setLidClosed(true);
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("lidApplies")), 1u);
+    QVERIFY(m_harness->settle());
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), applies + 1);
+
+    auto const laptop = m_harness->config()->outputs().at(1);
+    auto const external = m_harness->config()->outputs().at(2);
+    QVERIFY(!laptop->enabled());
+    QVERIFY(external->enabled());
+    QCOMPARE(external->position(), QPointF(0, 0));
+
+    // Opening it brings back the layout from before.
+    m_harness->upower().setLidClosed(false);
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("lidApplies")), 2u);
+    QVERIFY(m_harness->settle());
+    QCOMPARE(Fingerprint::config(m_harness->config()), opened);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), applies + 2);
+}
+
+void TestDaemon::lidWithoutExternal()
+{
+    m_harness->upower().setLidPresent(true);
+    start("singleOutput.json");
+    QTRY_VERIFY(m_harness->daemon()->upower()->lidPresent());
+
+    // Nothing to switch to, the panel stays as it is.
+    m_harness->upower().setLidClosed(true);
+    QTRY_VERIFY(m_harness->daemon()->upower()->lidClosed());
+    m_harness->upower().setLidClosed(false);
+    QTRY_VERIFY(!m_harness->daemon()->upower()->lidClosed());
+
+    QCOMPARE(m_harness->counter(QStringLiteral("lidApplies")), 0u);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 0u);
+    QVERIFY(m_harness->config()->outputs().at(1)->enabled());
+}
+
+void TestDaemon::lidClosedAtStart()
+{
+    m_harness->upower().setLidPresent(true);
+    m_harness->upower().setLidClosed(true);
+    start("laptopAndExternal.json");
+
+    // Known from the start, there is no change to announce it.
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("lidApplies")), 1u);
+    QVERIFY(m_harness->settle());
+    QVERIFY(!m_harness->config()->outputs().at(1)->enabled());
+    QVERIFY(m_harness->config()->outputs().at(2)->enabled());
+}
+
+void TestDaemon::hotplugWithLidClosed()
+{
+    m_harness->upower().setLidPresent(true);
+    m_harness->upower().setLidClosed(true);
+    start("singleOutput.json");
+    QTRY_VERIFY(m_harness->daemon()->upower()->lidClosed());
+    QCOMPARE(m_harness->counter(QStringLiteral("lidApplies")), 0u);
+
+    // The generated layout has the panel on, the closed lid still turns it off.
+    QVERIFY(m_harness->hotplug("switchDisplayTwoScreens.json"));
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("lidApplies")), 1u);
+    QVERIFY(m_harness->settle());
+    QVERIFY(!m_harness->config()->outputs().at(1)->enabled());
+    QVERIFY(m_harness->config()->outputs().at(2)->enabled());
+}
+
+void TestDaemon::battery()
+{
+    start("laptopHighRefresh.json");
+    auto const panel = m_harness->config()->outputs().at(1);
+    panel->set_auto_refresh_rate(true);
+    QCOMPARE(panel->auto_mode()->refresh(), 165000);
+
+    m_harness->upower().setOnBattery(true);
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("powerApplies")), 1u);
+    QVERIFY(m_harness->settle());
+    QVERIFY(!panel->auto_refresh_rate());
+    QCOMPARE(panel->auto_mode()->refresh(), 60000);
+
+    // Back on AC the rate is picked automatically again, with one more apply.
+    m_harness->upower().setOnBattery(false);
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("powerApplies")), 2u);
+    QVERIFY(m_harness->settle());
+    QVERIFY(panel->auto_refresh_rate());
+    QCOMPARE(panel->auto_mode()->refresh(), 165000);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 2u);
+}
+
+void TestDaemon::skipUnchanged()
+{
+    start("singleOutput.json");
+    m_harness->osd().answer = KDisplay::OsdAction::ExtendRight;
+
+    QVERIFY(m_harness->hotplug("switchDisplayTwoScreens.json"));
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+    QVERIFY(m_harness->settle());
+
+    // Already extended to the right.
+    m_harness->daemon()->applyLayoutPreset(QStringLiteral("ExtendRight"));
+    QCOMPARE(m_harness->counter(QStringLiteral("skippedApplies")), 1u);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+
+    m_harness->daemon()->applyLayoutPreset(QStringLiteral("ExtendLeft"));
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 2u);
+    QVERIFY(m_harness->settle());
+    QCOMPARE(m_harness->counter(QStringLiteral("skippedApplies")), 1u);
+}
+
+void TestDaemon::requestLayoutPreset()
+{
+    start("laptopAndExternal.json");
+    QTRY_COMPARE(m_harness->osd().prepares, 1);
+
+    auto const daemon = m_harness->daemon();
+    QSignalSpy spy(daemon, &KDisplayDaemon::layoutApplied);
+
+    auto const id = daemon->requestLayoutPreset(QStringLiteral("ExtendRight"));
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.last().at(0).toUInt(), id);
+    QCOMPARE(spy.last().at(1).toBool(), true);
+    QCOMPARE(daemon->property("layout").toString(), QStringLiteral("ExtendRight"));
+    QVERIFY(m_harness->settle());
+
+    // Nothing to apply, but still reported after the call returned.
+    auto const unchanged = daemon->requestLayoutPreset(QStringLiteral("ExtendRight"));
+    QVERIFY(unchanged != id);
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.last().at(0).toUInt(), unchanged);
+    QCOMPARE(spy.last().at(1).toBool(), true);
+    QCOMPARE(spy.last().at(2).toUInt(), 0u);
+
+    auto const unknown = daemon->requestLayoutPreset(QStringLiteral("Sideways"));
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.last().at(0).toUInt(), unknown);
+    QCOMPARE(spy.last().at(1).toBool(), false);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+}
+
+void TestDaemon::userBeforeSensor()
+{
+    start("laptopAndExternal.json");
+    QTRY_COMPARE(m_harness->osd().prepares, 1);
+
+    auto const daemon = m_harness->daemon();
+    QSignalSpy spy(daemon, &KDisplayDaemon::layoutApplied);
+    daemon->requestLayoutPreset(QStringLiteral("ExtendRight"));
+    QVERIFY(spy.wait());
+    QVERIFY(m_harness->settle());
+
+    auto config = m_harness->config();
+    config->set_supported_features(Config::Feature::AutoRotation | Config::Feature::TabletMode);
+    config->outputs().at(1)->set_auto_rotate_only_in_tablet_mode(false);
+
+    auto sensor = m_harness->orientationSensor();
+    sensor->setReading(QOrientationReading::TopUp);
+    daemon->setAutoRotate(true);
+    QVERIFY(m_harness->settle());
+    sensor->setEnabled(true);
+    daemon->resetStatistics();
+
+    // The layout the user picks is applied right away, with the sensor's apply still in flight.
+    sensor->setReading(QOrientationReading::LeftUp);
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+    auto const id = daemon->requestLayoutPreset(QStringLiteral("ExtendLeft"));
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 2u);
+
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.last().at(0).toUInt(), id);
+    QCOMPARE(spy.last().at(1).toBool(), true);
+    QVERIFY(m_harness->settle());
+    QCOMPARE(daemon->property("layout").toString(), QStringLiteral("ExtendLeft"));
+    QCOMPARE(m_harness->counter(QStringLiteral("orientationApplies")), 0u);
+
+    auto const queue = daemon->getStatistics()[QStringLiteral("queue")].toMap();
+    QCOMPARE(queue[QStringLiteral("depth")].toInt(), 0);
+    auto const sensorQueue = queue[QStringLiteral("sensor")].toMap();
+    QCOMPARE(sensorQueue[QStringLiteral("superseded")].toULongLong(), 1ull);
+    auto const userQueue = queue[QStringLiteral("user")].toMap();
+    QCOMPARE(userQueue[QStringLiteral("waits")].toULongLong(), 1ull);
+}
+
+void TestDaemon::profiles()
+{
+    start("singleOutput.json");
+    m_harness->osd().answer = KDisplay::OsdAction::ExtendRight;
+
+    QVERIFY(m_harness->hotplug("switchDisplayTwoScreens.json"));
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+    QVERIFY(m_harness->settle());
+
+    auto const daemon = m_harness->daemon();
+    QVERIFY(daemon->saveProfile(QStringLiteral("docked")));
+    QVERIFY(!daemon->saveProfile(QString()));
+    QCOMPARE(daemon->property("profiles").toStringList(), QStringList{QStringLiteral("docked")});
+
+    QSignalSpy spy(daemon, &KDisplayDaemon::layoutApplied);
+    daemon->requestLayoutPreset(QStringLiteral("ExtendLeft"));
+    QVERIFY(spy.wait());
+    QVERIFY(m_harness->settle());
+    QCOMPARE(m_harness->config()->outputs().at(1)->position(), QPointF(1920, 0));
+
+    // Back with a single apply.
+    auto const id = daemon->requestProfile(QStringLiteral("docked"));
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.last().at(0).toUInt(), id);
+    QCOMPARE(spy.last().at(1).toBool(), true);
+    QVERIFY(m_harness->settle());
+    QCOMPARE(m_harness->counter(QStringLiteral("applies")), 3u);
+    QCOMPARE(m_harness->config()->outputs().at(1)->position(), QPointF(0, 0));
+    QCOMPARE(m_harness->config()->outputs().at(2)->position(), QPointF(1280, 0));
+
+    daemon->requestProfile(QStringLiteral("unknown"));
+    QVERIFY(spy.wait());
+    QCOMPARE(spy.last().at(1).toBool(), false);
+
+    // Only offered for the outputs it was saved for.
+    QVERIFY(m_harness->hotplug("singleOutput.json"));
+    QVERIFY(m_harness->settle());
+    QTRY_VERIFY(daemon->property("profiles").toStringList().isEmpty());
+
+    // Picked from the OSD on the next dock.
+    m_harness->osd().answer = KDisplay::OsdAction::NoAction;
+    m_harness->osd().answerProfile = 0;
+    QVERIFY(m_harness->hotplug("switchDisplayTwoScreens.json"));
+    QTRY_COMPARE(m_harness->osd().requests, 2);
+    QCOMPARE(m_harness->osd().profiles, QStringList{QStringLiteral("docked")});
+    QTRY_VERIFY(m_harness->config()->outputs().at(2)->enabled());
+    QVERIFY(m_harness->settle());
+    QCOMPARE(m_harness->config()->outputs().at(2)->position(), QPointF(1280, 0));
+
+    QVERIFY(daemon->removeProfile(QStringLiteral("docked")));
+    QVERIFY(daemon->property("profiles").toStringList().isEmpty());
+}
+
+void TestDaemon::snapshot()
+{
+    start("singleOutput.json");
+    m_harness->osd().answer = KDisplay::OsdAction::ExtendRight;
+
+    auto const daemon = m_harness->daemon();
+    QSignalSpy spy(daemon, &KDisplayDaemon::snapshotChanged);
+
+    auto const before = daemon->getSnapshot();
+    QVERIFY(before.isValid());
+    Snapshot::Mapping const single(before.fileDescriptor());
+    QVERIFY(single.view().isValid());
+    QCOMPARE(single.view().outputCount(), 1);
+    QCOMPARE(single.view().fingerprint(), Fingerprint::config(m_harness->config()));
+
+    // Shared until the layout changes.
+    QCOMPARE(Snapshot::Mapping(daemon->getSnapshot().fileDescriptor()).view().generation(),
+             single.view().generation());
+
+    QVERIFY(m_harness->hotplug("switchDisplayTwoScreens.json"));
+    QTRY_COMPARE(m_harness->counter(QStringLiteral("applies")), 1u);
+    QVERIFY(m_harness->settle());
+    QVERIFY(spy.count() >= 1);
+
+    Snapshot::Mapping const extended(daemon->getSnapshot().fileDescriptor());
+    QVERIFY(extended.view().isValid());
+    QCOMPARE(extended.view().generation(), spy.last().first().toULongLong());
+    QVERIFY(extended.view().generation() > single.view().generation());
+    QCOMPARE(extended.view().outputCount(), 2);
+    QCOMPARE(extended.view().fingerprint(), Fingerprint::config(m_harness->config()));
+
+    // The old mapping stays readable.
+    QCOMPARE(single.view().outputCount(), 1);
+}
+
+QTEST_GUILESS_MAIN(TestDaemon)
+
+#include "testdaemon.moc"
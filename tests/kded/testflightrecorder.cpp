@@ -0,0 +1,67 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../plasma-integration/kded/flight_recorder.h"
+
+#include <QObject>
+#include <QtTest>
+
+class TestFlightRecorder : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void dump();
+    void wrapAround();
+};
+
+static QStringList records(FlightRecorder const& recorder)
+{
+    auto lines = recorder.dump().split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    lines.removeIf([](auto const& line) { return line.startsWith(QLatin1Char('#')); });
+    return lines;
+}
+
+void TestFlightRecorder::dump()
+{
+    FlightRecorder recorder;
+    QVERIFY(records(recorder).isEmpty());
+
+    recorder.record(FlightRecorder::Event::Hotplug, 0x1234, 2);
+    recorder.record(FlightRecorder::Event::OsdReply, 0x1234, 2, -1);
+
+    auto const lines = records(recorder);
+    QCOMPARE(lines.size(), 2);
+
+    auto const hotplug = lines[0].split(QLatin1Char(' '));
+    QCOMPARE(hotplug.size(), 5);
+    QCOMPARE(hotplug[1], QStringLiteral("hotplug"));
+    QCOMPARE(hotplug[3], QStringLiteral("2"));
+    QCOMPARE(hotplug[4], QStringLiteral("0000000000001234"));
+
+    auto const reply = lines[1].split(QLatin1Char(' '));
+    QCOMPARE(reply[1], QStringLiteral("osdReply"));
+    QCOMPARE(reply[2], QStringLiteral("-1"));
+    QVERIFY(reply[0].toLongLong() >= hotplug[0].toLongLong());
+}
+
+void TestFlightRecorder::wrapAround()
+{
+    FlightRecorder recorder;
+    int const total = FlightRecorder::capacity + 10;
+    for (int i = 0; i < total; i++) {
+        recorder.record(FlightRecorder::Event::Orientation, 0, 1, i);
+    }
+
+    // Only the newest records are kept, oldest first.
+    auto const lines = records(recorder);
+    QCOMPARE(lines.size(), static_cast<qsizetype>(FlightRecorder::capacity));
+    QCOMPARE(lines.first().split(QLatin1Char(' '))[2].toInt(), 10);
+    QCOMPARE(lines.last().split(QLatin1Char(' '))[2].toInt(), total - 1);
+}
+
+QTEST_GUILESS_MAIN(TestFlightRecorder)
+
+#include "testflightrecorder.moc"
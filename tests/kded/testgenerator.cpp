@@ -16,13 +16,13 @@
  *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA   *
  *************************************************************************************/
 #include "../../plasma-integration/kded/generator.h"
+#include "fake_backend.h"
 
 #include <QObject>
 #include <QtTest>
 
 #include <disman/backendmanager_p.h>
 #include <disman/config.h>
-#include <disman/getconfigoperation.h>
 #include <disman/output.h>
 
 using namespace Disman;
@@ -41,21 +41,16 @@ private Q_SLOTS:
     void cleanupTestCase();
 
     void switchDisplayTwoScreens();
+    void lid();
+    void lidSingleOutput();
 };
 
 Disman::ConfigPtr testScreenConfig::loadConfig(const QByteArray& fileName)
 {
-    Disman::BackendManager::instance()->shutdown_backend();
-
-    QByteArray path(TEST_DATA "configs/" + fileName);
-    qputenv("DISMAN_BACKEND_ARGS", "TEST_DATA=" + path);
-
-    Disman::GetConfigOperation* op = new Disman::GetConfigOperation;
-    if (!op->exec()) {
-        qWarning() << op->error_string();
+    auto config = FakeBackend::loadFixture(fileName);
+    if (!config) {
         return ConfigPtr();
     }
-    auto config = op->config();
     config->set_supported_features(Config::Feature::PrimaryDisplay);
     return config;
 }
@@ -150,6 +145,45 @@ void testScreenConfig::switchDisplayTwoScreensNoCommonMode()
     QCOMPARE(config->primary_output(), laptop);
 }
 
+void testScreenConfig::lid()
+{
+    const ConfigPtr currentConfig = loadConfig("laptopLidOpenAndTwoExternal.json");
+    QVERIFY(currentConfig);
+    QVERIFY(!Generator::lidOpened(currentConfig));
+
+    // Closing disables the panel and puts the external outputs to use.
+    auto closed = Generator::lidClosed(currentConfig);
+    QVERIFY(closed);
+    QVERIFY(!closed->outputs().at(1)->enabled());
+    QVERIFY(closed->outputs().at(2)->enabled() || closed->outputs().at(3)->enabled());
+    QVERIFY(closed->primary_output() != closed->outputs().at(1));
+    QCOMPARE(closed->cause(), Config::Cause::interactive);
+    QVERIFY(Config::can_be_applied(closed));
+    QVERIFY(currentConfig->outputs().at(1)->enabled());
+    QVERIFY(!Generator::lidClosed(closed));
+
+    // Without an earlier layout the panel comes back left of the others.
+    auto opened = Generator::lidOpened(closed);
+    QVERIFY(opened);
+    OutputPtr laptop = opened->outputs().at(1);
+    QVERIFY(laptop->enabled());
+    QCOMPARE(laptop->position(), QPointF(0, 0));
+    for (auto const& [id, output] : opened->outputs()) {
+        if (output != laptop && output->enabled()) {
+            QVERIFY(!output->geometry().intersects(laptop->geometry()));
+        }
+    }
+}
+
+void testScreenConfig::lidSingleOutput()
+{
+    const ConfigPtr currentConfig = loadConfig("singleOutput.json");
+    QVERIFY(currentConfig);
+
+    QVERIFY(!Generator::lidClosed(currentConfig));
+    QVERIFY(!Generator::lidOpened(currentConfig));
+}
+
 QTEST_MAIN(testScreenConfig)
 
 #include "testgenerator.moc"
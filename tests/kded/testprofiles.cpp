@@ -0,0 +1,181 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../common/fingerprint.h"
+#include "../../plasma-integration/kded/profiles.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+#include <disman/output.h>
+
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using namespace Disman;
+
+class TestProfiles : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void saveAndLoad();
+    void otherOutputs();
+    void replaceAndRemove();
+    void rejected();
+    void invalidStore();
+
+private:
+    ConfigPtr docked();
+    QString path() const;
+
+    std::unique_ptr<QTemporaryDir> m_dir;
+};
+
+ConfigPtr TestProfiles::docked()
+{
+    auto config = FakeBackend::loadFixture("laptopAndExternal.json");
+    if (!config) {
+        return nullptr;
+    }
+    auto const external = config->outputs().at(2);
+    external->set_enabled(true);
+    external->set_position(QPointF(1280, 0));
+    external->set_scale(1.5);
+    return config;
+}
+
+QString TestProfiles::path() const
+{
+    return m_dir->filePath(QStringLiteral("profiles"));
+}
+
+void TestProfiles::initTestCase()
+{
+    qputenv("DISMAN_IN_PROCESS", "1");
+    qputenv("DISMAN_LOGGING", "false");
+    qputenv("DISMAN_BACKEND", "fake");
+}
+
+void TestProfiles::init()
+{
+    m_dir = std::make_unique<QTemporaryDir>();
+    QVERIFY(m_dir->isValid());
+}
+
+void TestProfiles::cleanupTestCase()
+{
+    BackendManager::instance()->shutdown_backend();
+}
+
+void TestProfiles::saveAndLoad()
+{
+    auto const saved = docked();
+    QVERIFY(saved);
+    {
+        ProfileStore store(path());
+        QVERIFY(store.save(QStringLiteral("docked"), saved));
+        auto const alone = FakeBackend::loadFixture("laptopAndExternal.json");
+        QVERIFY(store.save(QStringLiteral("alone"), alone));
+    }
+
+    ProfileStore store(path());
+    store.load();
+
+    auto const current = FakeBackend::loadFixture("laptopAndExternal.json");
+    QVERIFY(current);
+    QCOMPARE(store.names(current),
+             QStringList({QStringLiteral("alone"), QStringLiteral("docked")}));
+
+    // The layout comes back as saved, on a copy of the current config.
+    auto const before = Fingerprint::config(current);
+    auto const layout = store.layout(QStringLiteral("docked"), current);
+    QVERIFY(layout);
+    QVERIFY(layout != current);
+    QCOMPARE(Fingerprint::config(layout), Fingerprint::config(saved));
+    QCOMPARE(Fingerprint::config(current), before);
+    QCOMPARE(layout->cause(), Config::Cause::interactive);
+
+    auto const external = layout->outputs().at(2);
+    QVERIFY(external->enabled());
+    QCOMPARE(external->position(), QPointF(1280, 0));
+    QCOMPARE(external->scale(), 1.5);
+
+    QVERIFY(!store.layout(QStringLiteral("unknown"), current));
+}
+
+void TestProfiles::otherOutputs()
+{
+    ProfileStore store(path());
+    QVERIFY(store.save(QStringLiteral("docked"), docked()));
+
+    // Profiles only show up for the outputs they were saved for.
+    auto const other = FakeBackend::loadFixture("laptopAndTwoExternal.json");
+    QVERIFY(other);
+    QVERIFY(store.names(other).isEmpty());
+    QVERIFY(!store.layout(QStringLiteral("docked"), other));
+
+    // The same name can stand for a layout of other outputs.
+    QVERIFY(store.save(QStringLiteral("docked"), other));
+    QCOMPARE(store.names(other), QStringList{QStringLiteral("docked")});
+    QCOMPARE(store.names(docked()), QStringList{QStringLiteral("docked")});
+}
+
+void TestProfiles::replaceAndRemove()
+{
+    ProfileStore store(path());
+    auto const config = docked();
+    QVERIFY(config);
+    QVERIFY(store.save(QStringLiteral("docked"), config));
+
+    config->outputs().at(2)->set_scale(2);
+    QVERIFY(store.save(QStringLiteral("docked"), config));
+    QCOMPARE(store.names(config).size(), 1);
+    QCOMPARE(store.layout(QStringLiteral("docked"), config)->outputs().at(2)->scale(), 2.);
+
+    QVERIFY(store.remove(QStringLiteral("docked"), config));
+    QVERIFY(!store.remove(QStringLiteral("docked"), config));
+    QVERIFY(store.names(config).isEmpty());
+
+    ProfileStore reloaded(path());
+    reloaded.load();
+    QVERIFY(reloaded.names(config).isEmpty());
+}
+
+void TestProfiles::rejected()
+{
+    ProfileStore store(path());
+    auto const config = FakeBackend::loadFixture("laptopAndExternal.json");
+    QVERIFY(config);
+
+    QVERIFY(!store.save(QString(), config));
+
+    config->outputs().at(1)->set_enabled(false);
+    QVERIFY(!store.save(QStringLiteral("dark"), config));
+    QVERIFY(store.names(config).isEmpty());
+    QVERIFY(!QFile::exists(path()));
+}
+
+void TestProfiles::invalidStore()
+{
+    QFile file(path());
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a profile store");
+    file.close();
+
+    ProfileStore store(path());
+    store.load();
+    QVERIFY(store.names(FakeBackend::loadFixture("laptopAndExternal.json")).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestProfiles)
+
+#include "testprofiles.moc"
+#include "fake_backend.h"
@@ -0,0 +1,205 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../plasma-integration/kded/refresh_policy.h"
+#include "fake_backend.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+#include <disman/mode.h>
+#include <disman/output.h>
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Disman;
+
+class TestRefreshPolicy : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void lowerAndRestore();
+    void floor();
+    void manualRate();
+    void changedInBetween();
+    void noLowerRate();
+    void restoreAfterRestart();
+    void uncommitted();
+
+private:
+    ConfigPtr loadConfig(QByteArray const& fileName);
+};
+
+ConfigPtr TestRefreshPolicy::loadConfig(QByteArray const& fileName)
+{
+    auto config = FakeBackend::loadFixture(fileName);
+    if (!config) {
+        return nullptr;
+    }
+    for (auto const& [id, output] : config->outputs()) {
+        output->set_auto_refresh_rate(true);
+    }
+    return config;
+}
+
+void TestRefreshPolicy::initTestCase()
+{
+    qputenv("DISMAN_IN_PROCESS", "1");
+    qputenv("DISMAN_LOGGING", "false");
+    qputenv("DISMAN_BACKEND", "fake");
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestRefreshPolicy::cleanupTestCase()
+{
+    BackendManager::instance()->shutdown_backend();
+}
+
+void TestRefreshPolicy::init()
+{
+    // What earlier tests lowered without restoring.
+    auto group
+        = KSharedConfig::openConfig(QStringLiteral("kdisplayrc"))->group(QStringLiteral("Power"));
+    group.deleteEntry("LoweredOutputs");
+    group.sync();
+}
+
+void TestRefreshPolicy::lowerAndRestore()
+{
+    auto const config = loadConfig("laptopHighRefresh.json");
+    QVERIFY(config);
+    auto const panel = config->outputs().at(1);
+    QCOMPARE(panel->auto_mode()->refresh(), 165000);
+
+    RefreshPolicy policy(60000);
+    QVERIFY(policy.lower(config));
+    QVERIFY(!panel->auto_refresh_rate());
+    QCOMPARE(panel->auto_mode()->refresh(), 60000);
+    QCOMPARE(panel->auto_mode()->size(), QSize(1920, 1080));
+    QVERIFY(!policy.lowered());
+    policy.commit();
+    QVERIFY(policy.lowered());
+
+    // Lowered already.
+    QVERIFY(!policy.lower(config));
+    policy.commit();
+
+    QVERIFY(policy.restore(config));
+    QVERIFY(panel->auto_refresh_rate());
+    QCOMPARE(panel->auto_mode()->refresh(), 165000);
+    policy.commit();
+    QVERIFY(!policy.lowered());
+    QVERIFY(!policy.restore(config));
+}
+
+void TestRefreshPolicy::floor()
+{
+    auto const config = loadConfig("laptopHighRefresh.json");
+    QVERIFY(config);
+
+    RefreshPolicy policy(100000);
+    QVERIFY(policy.lower(config));
+    QCOMPARE(config->outputs().at(1)->auto_mode()->refresh(), 144000);
+}
+
+void TestRefreshPolicy::manualRate()
+{
+    auto const config = loadConfig("laptopHighRefresh.json");
+    QVERIFY(config);
+    auto const panel = config->outputs().at(1);
+    panel->set_auto_refresh_rate(false);
+
+    // A rate the user picked stays.
+    RefreshPolicy policy(60000);
+    QVERIFY(!policy.lower(config));
+    QCOMPARE(panel->auto_mode()->refresh(), 165000);
+}
+
+void TestRefreshPolicy::changedInBetween()
+{
+    auto const config = loadConfig("laptopHighRefresh.json");
+    QVERIFY(config);
+    auto const panel = config->outputs().at(1);
+
+    RefreshPolicy policy(60000);
+    QVERIFY(policy.lower(config));
+    policy.commit();
+
+    // Picked by the user while on battery, so it stays on AC.
+    panel->set_refresh_rate(144000);
+    QVERIFY(!policy.restore(config));
+    QVERIFY(!panel->auto_refresh_rate());
+    QCOMPARE(panel->auto_mode()->refresh(), 144000);
+}
+
+void TestRefreshPolicy::noLowerRate()
+{
+    auto const config = loadConfig("singleOutput.json");
+    QVERIFY(config);
+
+    RefreshPolicy policy(60000);
+    QVERIFY(!policy.lower(config));
+    QVERIFY(config->outputs().at(1)->auto_refresh_rate());
+}
+
+void TestRefreshPolicy::restoreAfterRestart()
+{
+    auto const config = loadConfig("laptopHighRefresh.json");
+    QVERIFY(config);
+    auto const panel = config->outputs().at(1);
+
+    {
+        RefreshPolicy policy(60000);
+        QVERIFY(!policy.lowered());
+        QVERIFY(policy.lower(config));
+        policy.commit();
+    }
+
+    // Like a daemon started again after it ended on battery.
+    RefreshPolicy policy(60000);
+    QVERIFY(policy.lowered());
+    QVERIFY(policy.restore(config));
+    QVERIFY(panel->auto_refresh_rate());
+    QCOMPARE(panel->auto_mode()->refresh(), 165000);
+    policy.commit();
+    QVERIFY(!policy.lowered());
+
+    QVERIFY(!RefreshPolicy(60000).lowered());
+}
+
+void TestRefreshPolicy::uncommitted()
+{
+    auto const config = loadConfig("laptopHighRefresh.json");
+    QVERIFY(config);
+
+    // Like an apply that failed, nothing is kept for the next start.
+    {
+        RefreshPolicy policy(60000);
+        QVERIFY(policy.lower(config));
+    }
+    QVERIFY(!RefreshPolicy(60000).lowered());
+
+    // A failed restore still leaves what to restore.
+    auto const other = loadConfig("laptopHighRefresh.json");
+    QVERIFY(other);
+    RefreshPolicy policy(60000);
+    QVERIFY(policy.lower(other));
+    policy.commit();
+    QVERIFY(policy.restore(other));
+    QVERIFY(policy.lowered());
+    QVERIFY(RefreshPolicy(60000).lowered());
+}
+
+QTEST_GUILESS_MAIN(TestRefreshPolicy)
+
+#include "testrefreshpolicy.moc"
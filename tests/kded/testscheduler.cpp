@@ -0,0 +1,342 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../plasma-integration/kded/apply_scheduler.h"
+#include "fake_backend.h"
+
+#include <disman/backendmanager_p.h>
+#include <disman/config.h>
+
+#include <QObject>
+#include <QtTest>
+
+using namespace Disman;
+
+using Priority = ApplyScheduler::Priority;
+using Outcome = ApplyScheduler::Outcome;
+
+class TestScheduler : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+
+    void startRightAway();
+    void unchanged();
+    void coalesce();
+    void priorityOrder();
+    void userDropsSensor();
+    void retry();
+    void retrySuperseded();
+    void finishedOutOfOrder();
+    void statistics();
+
+private:
+    ApplyScheduler::Make make(ConfigPtr const& config);
+    ApplyScheduler::Done done(QByteArray const& name);
+    bool ended(char const* name, Outcome outcome) const;
+    QVariantMap stats(ApplyScheduler const& scheduler, char const* priority) const;
+    ApplyScheduler::Apply recorder();
+    bool finish(ApplyScheduler& scheduler, bool success);
+
+    ConfigPtr m_config;
+    std::vector<ConfigPtr> m_applied;
+    // Of the applies in flight, in the order they were started.
+    std::vector<uint64_t> m_started;
+    bool m_changes{true};
+    QHash<QByteArray, Outcome> m_outcomes;
+};
+
+void TestScheduler::initTestCase()
+{
+    qputenv("DISMAN_IN_PROCESS", "1");
+    qputenv("DISMAN_LOGGING", "false");
+    qputenv("DISMAN_BACKEND", "fake");
+    m_config = FakeBackend::loadFixture("singleOutput.json");
+    QVERIFY(m_config);
+}
+
+void TestScheduler::cleanupTestCase()
+{
+    BackendManager::instance()->shutdown_backend();
+}
+
+void TestScheduler::init()
+{
+    m_applied.clear();
+    m_started.clear();
+    m_changes = true;
+    m_outcomes.clear();
+}
+
+ApplyScheduler::Make TestScheduler::make(ConfigPtr const& config)
+{
+    return [config] { return config; };
+}
+
+ApplyScheduler::Done TestScheduler::done(QByteArray const& name)
+{
+    return [this, name](Outcome outcome) { m_outcomes.insert(name, outcome); };
+}
+
+bool TestScheduler::ended(char const* name, Outcome outcome) const
+{
+    auto const it = m_outcomes.constFind(name);
+    return it != m_outcomes.constEnd() && *it == outcome;
+}
+
+QVariantMap TestScheduler::stats(ApplyScheduler const& scheduler, char const* priority) const
+{
+    return scheduler.toVariantMap()[QString::fromLatin1(priority)].toMap();
+}
+
+ApplyScheduler::Apply TestScheduler::recorder()
+{
+    return [this](ConfigPtr const& config, uint64_t id) {
+        if (!m_changes) {
+            return false;
+        }
+        m_applied.push_back(config);
+        m_started.push_back(id);
+        return true;
+    };
+}
+
+bool TestScheduler::finish(ApplyScheduler& scheduler, bool success)
+{
+    // The oldest apply in flight, or none to check that nothing is left.
+    uint64_t id = 0;
+    if (!m_started.empty()) {
+        id = m_started.front();
+        m_started.erase(m_started.begin());
+    }
+    return finish(scheduler, id, success);
+}
+
+void TestScheduler::startRightAway()
+{
+    ApplyScheduler scheduler(recorder());
+
+    scheduler.submit(Priority::Sensor, QStringLiteral("orientation"), make(m_config), done("a"));
+    QCOMPARE(m_applied.size(), 1u);
+    QVERIFY(scheduler.busy());
+    QVERIFY(m_outcomes.isEmpty());
+
+    QVERIFY(!finish(scheduler, true));
+    QVERIFY(!scheduler.busy());
+    QVERIFY(ended("a", Outcome::Applied));
+}
+
+void TestScheduler::unchanged()
+{
+    ApplyScheduler scheduler(recorder());
+    m_changes = false;
+
+    scheduler.submit(Priority::User, QStringLiteral("layout"), make(m_config), done("a"));
+    QVERIFY(ended("a", Outcome::Unchanged));
+    QVERIFY(!scheduler.busy());
+
+    // Nothing to apply is no failure.
+    scheduler.submit(Priority::User, QStringLiteral("layout"), make(nullptr), done("b"));
+    QVERIFY(ended("b", Outcome::Skipped));
+
+    scheduler.submit(
+        Priority::User,
+        QStringLiteral("layout"),
+        [] { return std::optional<ConfigPtr>(); },
+        done("c"));
+    QVERIFY(ended("c", Outcome::Failed));
+    QVERIFY(m_applied.empty());
+
+    QCOMPARE(stats(scheduler, "user")[QStringLiteral("skipped")].toULongLong(), 1ull);
+    QCOMPARE(stats(scheduler, "user")[QStringLiteral("failed")].toULongLong(), 1ull);
+}
+
+void TestScheduler::coalesce()
+{
+    ApplyScheduler scheduler(recorder());
+    auto const second = m_config->clone();
+
+    scheduler.submit(Priority::Sensor, QStringLiteral("orientation"), make(m_config));
+
+    // Only the last one of the same kind is applied once the first finished.
+    auto made = 0;
+    scheduler.submit(
+        Priority::Sensor,
+        QStringLiteral("power"),
+        [&made] {
+            made++;
+            return ConfigPtr();
+        },
+        done("a"));
+    scheduler.submit(Priority::Sensor, QStringLiteral("power"), make(second), done("b"));
+    QCOMPARE(scheduler.depth(), 1);
+    QVERIFY(ended("a", Outcome::Superseded));
+    QCOMPARE(made, 0);
+
+    QVERIFY(finish(scheduler, true));
+    QCOMPARE(m_applied.size(), 2u);
+    QCOMPARE(m_applied.back(), second);
+    QVERIFY(!finish(scheduler, true));
+    QVERIFY(ended("b", Outcome::Applied));
+}
+
+void TestScheduler::priorityOrder()
+{
+    ApplyScheduler scheduler(recorder());
+    auto const sensor = m_config->clone();
+    auto const hotplug = m_config->clone();
+
+    scheduler.submit(Priority::User, QStringLiteral("layout"), make(m_config));
+    scheduler.submit(Priority::Sensor, QStringLiteral("orientation"), make(sensor));
+    scheduler.submit(Priority::Hotplug, QStringLiteral("lid"), make(hotplug));
+    QCOMPARE(m_applied.size(), 1u);
+    QCOMPARE(scheduler.depth(), 2);
+
+    QVERIFY(finish(scheduler, true));
+    QCOMPARE(m_applied.back(), hotplug);
+    QVERIFY(finish(scheduler, true));
+    QCOMPARE(m_applied.back(), sensor);
+    QVERIFY(!finish(scheduler, true));
+}
+
+void TestScheduler::userDropsSensor()
+{
+    ApplyScheduler scheduler(recorder());
+    auto const user = m_config->clone();
+
+    scheduler.submit(Priority::Hotplug, QStringLiteral("lid"), make(m_config), done("lid"));
+    scheduler.submit(Priority::Sensor, QStringLiteral("power"), make(m_config), done("power"));
+    QCOMPARE(scheduler.depth(), 1);
+
+    // Started without waiting for the lid, which the user's layout replaces.
+    scheduler.submit(Priority::User, QStringLiteral("layout"), make(user), done("user"));
+    QVERIFY(ended("power", Outcome::Superseded));
+    QCOMPARE(scheduler.depth(), 0);
+    QCOMPARE(m_applied.size(), 2u);
+    QCOMPARE(m_applied.back(), user);
+
+    QVERIFY(!finish(scheduler, true));
+    QVERIFY(ended("lid", Outcome::Superseded));
+    QVERIFY(scheduler.busy());
+    QVERIFY(!finish(scheduler, true));
+    QVERIFY(ended("user", Outcome::Applied));
+
+    QCOMPARE(stats(scheduler, "sensor")[QStringLiteral("dropped")].toULongLong(), 1ull);
+    QCOMPARE(stats(scheduler, "hotplug")[QStringLiteral("superseded")].toULongLong(), 1ull);
+}
+
+void TestScheduler::retry()
+{
+    ApplyScheduler scheduler(recorder());
+
+    scheduler.submit(Priority::User, QStringLiteral("layout"), make(m_config), done("a"));
+    QElapsedTimer timer;
+    timer.start();
+
+    // Tried again after 100, 200 and 400 ms with the same config.
+    for (int retry = 1; retry <= ApplyScheduler::max_retries; retry++) {
+        QVERIFY(!finish(scheduler, false));
+        QVERIFY(!scheduler.busy());
+        QCOMPARE(scheduler.depth(), 1);
+        QTRY_COMPARE(m_applied.size(), size_t(retry + 1));
+        QCOMPARE(m_applied.back(), m_config);
+    }
+    QVERIFY(timer.elapsed() >= 700);
+    QVERIFY(m_outcomes.isEmpty());
+
+    QVERIFY(!finish(scheduler, false));
+    QVERIFY(ended("a", Outcome::Failed));
+    QCOMPARE(scheduler.depth(), 0);
+    QCOMPARE(stats(scheduler, "user")[QStringLiteral("retries")].toULongLong(), 3ull);
+    QCOMPARE(stats(scheduler, "user")[QStringLiteral("failed")].toULongLong(), 1ull);
+}
+
+void TestScheduler::retrySuperseded()
+{
+    ApplyScheduler scheduler(recorder());
+    auto const second = m_config->clone();
+
+    scheduler.submit(Priority::User, QStringLiteral("layout"), make(m_config), done("a"));
+    QVERIFY(!finish(scheduler, false));
+
+    // A new layout is applied right away instead of waiting for the retry of the old one.
+    scheduler.submit(Priority::User, QStringLiteral("layout"), make(second), done("b"));
+    QVERIFY(ended("a", Outcome::Superseded));
+    QCOMPARE(m_applied.size(), 2u);
+    QCOMPARE(m_applied.back(), second);
+    QVERIFY(!finish(scheduler, true));
+    QVERIFY(ended("b", Outcome::Applied));
+
+    QTest::qWait(200);
+    QCOMPARE(m_applied.size(), 2u);
+}
+
+void TestScheduler::finishedOutOfOrder()
+{
+    ApplyScheduler scheduler(recorder());
+    auto const user = m_config->clone();
+
+    scheduler.submit(Priority::Sensor, QStringLiteral("orientation"), make(m_config), done("a"));
+    scheduler.submit(Priority::User, QStringLiteral("layout"), make(user), done("b"));
+    QCOMPARE(m_started.size(), 2u);
+
+    // The user's apply finishes before the sensor's one it started next to.
+    QVERIFY(!scheduler.finished(m_started.back(), true));
+    QVERIFY(ended("b", Outcome::Applied));
+    QVERIFY(!m_outcomes.contains("a"));
+    QVERIFY(scheduler.busy());
+
+    QVERIFY(!scheduler.finished(m_started.front(), true));
+    QVERIFY(ended("a", Outcome::Superseded));
+    QVERIFY(!scheduler.busy());
+
+    // Unknown or finished already.
+    QVERIFY(!scheduler.finished(m_started.front(), true));
+}
+
+void TestScheduler::statistics()
+{
+    ApplyScheduler scheduler(recorder());
+
+    scheduler.submit(Priority::Hotplug, QStringLiteral("lid"), make(m_config));
+    scheduler.submit(Priority::Sensor, QStringLiteral("orientation"), make(m_config));
+    scheduler.submit(Priority::Sensor, QStringLiteral("orientation"), make(m_config));
+    scheduler.submit(Priority::Sensor, QStringLiteral("power"), make(m_config));
+
+    auto map = scheduler.toVariantMap();
+    QCOMPARE(map[QStringLiteral("depth")].toInt(), 2);
+    QCOMPARE(map[QStringLiteral("maxDepth")].toInt(), 2);
+    QCOMPARE(map[QStringLiteral("inFlight")].toInt(), 1);
+
+    auto sensor = stats(scheduler, "sensor");
+    QCOMPARE(sensor[QStringLiteral("requests")].toULongLong(), 3ull);
+    QCOMPARE(sensor[QStringLiteral("superseded")].toULongLong(), 1ull);
+    QCOMPARE(sensor[QStringLiteral("waits")].toULongLong(), 0ull);
+
+    QTest::qWait(20);
+    QVERIFY(finish(scheduler, true));
+    QVERIFY(finish(scheduler, true));
+    QVERIFY(!finish(scheduler, true));
+
+    // Both waited for the lid.
+    sensor = stats(scheduler, "sensor");
+    QCOMPARE(sensor[QStringLiteral("waits")].toULongLong(), 2ull);
+    QVERIFY(sensor[QStringLiteral("waitMax")].toLongLong() >= 20000);
+    QVERIFY(sensor[QStringLiteral("waitSum")].toLongLong() >= 40000);
+    QCOMPARE(stats(scheduler, "hotplug")[QStringLiteral("waits")].toULongLong(), 1ull);
+
+    scheduler.resetStatistics();
+    map = scheduler.toVariantMap();
+    QCOMPARE(map[QStringLiteral("maxDepth")].toInt(), 0);
+    QCOMPARE(stats(scheduler, "sensor")[QStringLiteral("requests")].toULongLong(), 0ull);
+}
+
+QTEST_GUILESS_MAIN(TestScheduler)
+
+#include "testscheduler.moc"
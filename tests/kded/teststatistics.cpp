@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../plasma-integration/kded/statistics.h"
+
+#include <QObject>
+#include <QtTest>
+
+using namespace std::chrono_literals;
+
+class TestStatistics : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void stages();
+    void counters();
+    void reset();
+};
+
+static QVariantMap stage(Statistics const& statistics, QString const& name)
+{
+    return statistics.toVariantMap()[QStringLiteral("stages")].toMap()[name].toMap();
+}
+
+void TestStatistics::stages()
+{
+    Statistics statistics;
+    auto const start = Statistics::Clock::now();
+
+    statistics.mark(Statistics::Event::Hotplug, start);
+    statistics.mark(Statistics::Event::Apply, start + 3ms);
+    statistics.mark(Statistics::Event::ApplyFinished, start + 10ms);
+
+    // A re-apply does not count as a second hotplug to apply sample.
+    statistics.mark(Statistics::Event::Apply, start + 12ms);
+    statistics.mark(Statistics::Event::ApplyFinished, start + 40ms);
+
+    auto hotplugToApply = stage(statistics, QStringLiteral("hotplugToApply"));
+    QCOMPARE(hotplugToApply[QStringLiteral("count")].toULongLong(), 1ull);
+    QCOMPARE(hotplugToApply[QStringLiteral("sum")].toLongLong(), 3000ll);
+
+    auto hotplugToApplied = stage(statistics, QStringLiteral("hotplugToApplied"));
+    QCOMPARE(hotplugToApplied[QStringLiteral("count")].toULongLong(), 1ull);
+    QCOMPARE(hotplugToApplied[QStringLiteral("max")].toLongLong(), 10000ll);
+
+    auto applyToApplied = stage(statistics, QStringLiteral("applyToApplied"));
+    QCOMPARE(applyToApplied[QStringLiteral("count")].toULongLong(), 2ull);
+    QCOMPARE(applyToApplied[QStringLiteral("min")].toLongLong(), 7000ll);
+    QCOMPARE(applyToApplied[QStringLiteral("max")].toLongLong(), 28000ll);
+
+    // 7 ms lands in the bucket up to 10 ms, 28 ms in the one up to 50 ms.
+    auto const buckets = applyToApplied[QStringLiteral("buckets")].toList();
+    QCOMPARE(buckets.size(), 13);
+    QCOMPARE(buckets[3].toULongLong(), 1ull);
+    QCOMPARE(buckets[5].toULongLong(), 1ull);
+
+    auto osdRequestToReply = stage(statistics, QStringLiteral("osdRequestToReply"));
+    QCOMPARE(osdRequestToReply[QStringLiteral("count")].toULongLong(), 0ull);
+}
+
+void TestStatistics::counters()
+{
+    Statistics statistics;
+    statistics.count(Statistics::Counter::Applies);
+    statistics.count(Statistics::Counter::Applies);
+    statistics.count(Statistics::Counter::OsdCancellations);
+
+    auto const counters = statistics.toVariantMap()[QStringLiteral("counters")].toMap();
+    QCOMPARE(counters[QStringLiteral("applies")].toULongLong(), 2ull);
+    QCOMPARE(counters[QStringLiteral("reapplies")].toULongLong(), 0ull);
+    QCOMPARE(counters[QStringLiteral("osdCancellations")].toULongLong(), 1ull);
+}
+
+void TestStatistics::reset()
+{
+    Statistics statistics;
+    statistics.mark(Statistics::Event::Hotplug);
+    statistics.mark(Statistics::Event::Decision);
+    statistics.count(Statistics::Counter::Hotplugs);
+
+    statistics.reset();
+
+    auto const map = statistics.toVariantMap();
+    QVERIFY(map[QStringLiteral("lastEvents")].toMap().isEmpty());
+
+    auto const counters = map[QStringLiteral("counters")].toMap();
+    QCOMPARE(counters[QStringLiteral("hotplugs")].toULongLong(), 0ull);
+
+    auto const hotplugToDecision = stage(statistics, QStringLiteral("hotplugToDecision"));
+    QCOMPARE(hotplugToDecision[QStringLiteral("count")].toULongLong(), 0ull);
+}
+
+QTEST_GUILESS_MAIN(TestStatistics)
+
+#include "teststatistics.moc"
@@ -0,0 +1,211 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "daemon_harness.h"
+#include "fake_backend.h"
+
+#include "../../common/orientation_sensor.h"
+#include "../../plasma-integration/kded/daemon.h"
+
+#include <disman/config.h>
+#include <disman/output.h>
+
+#include <QDBusPendingCallWatcher>
+#include <QFile>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QtTest>
+
+#include <array>
+
+using namespace Disman;
+
+// Events per storm. Can be raised with KDISPLAY_STORM_EVENTS for longer local runs.
+static constexpr int default_events = 400;
+static constexpr int default_seed = 20261019;
+
+/**
+ * Fires randomized hotplugs and orientation changes at the daemon without waiting in between and
+ * checks that it settles with a bounded number of applies and without leaking.
+ */
+class TestStorm : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void storm();
+
+private:
+    struct Result {
+        int hotplugs{0};
+        int orientations{0};
+    };
+    Result runStorm(int events);
+
+    std::unique_ptr<DaemonHarness> m_harness;
+    std::vector<ConfigPtr> m_configs;
+    QRandomGenerator m_random;
+};
+
+static qint64 procStatus(QByteArray const& key)
+{
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    while (!file.atEnd()) {
+        auto const line = file.readLine();
+        if (line.startsWith(key + ':')) {
+            // The value is given in kB.
+            return line.mid(key.size() + 1).trimmed().split(' ').first().toLongLong() * 1024;
+        }
+    }
+    return -1;
+}
+
+void TestStorm::initTestCase()
+{
+    m_harness = std::make_unique<DaemonHarness>();
+    if (!m_harness->start("singleOutput.json")) {
+        QSKIP(qPrintable(m_harness->error()));
+    }
+
+    for (auto const fixture : {"singleOutput.json",
+                               "switchDisplayTwoScreens.json",
+                               "laptopAndExternal.json",
+                               "laptopLidOpenAndTwoExternal.json"}) {
+        auto config = FakeBackend::loadFixture(fixture);
+        QVERIFY(config);
+        m_configs.push_back(config);
+    }
+
+    // Fixed, so a failure reproduces. Other seeds can be tried through the environment.
+    auto const seed = qEnvironmentVariableIsSet("KDISPLAY_STORM_SEED")
+        ? qEnvironmentVariableIntValue("KDISPLAY_STORM_SEED")
+        : default_seed;
+    qInfo() << "Seed:" << seed;
+    m_random.seed(seed);
+
+    // Make the panel follow the (fake) orientation sensor.
+    auto config = m_harness->config();
+    config->set_supported_features(Config::Feature::AutoRotation | Config::Feature::TabletMode);
+    config->outputs().at(1)->set_auto_rotate_only_in_tablet_mode(false);
+    m_harness->orientationSensor()->setReading(QOrientationReading::TopUp);
+    m_harness->daemon()->setAutoRotate(true);
+    m_harness->orientationSensor()->setEnabled(true);
+    QVERIFY(m_harness->settle());
+}
+
+void TestStorm::cleanupTestCase()
+{
+    m_configs.clear();
+    m_harness.reset();
+}
+
+TestStorm::Result TestStorm::runStorm(int events)
+{
+    static constexpr std::array actions{
+        KDisplay::OsdAction::NoAction,
+        KDisplay::OsdAction::SwitchToExternal,
+        KDisplay::OsdAction::ExtendLeft,
+        KDisplay::OsdAction::ExtendRight,
+        KDisplay::OsdAction::Clone,
+    };
+    static constexpr std::array orientations{
+        QOrientationReading::TopUp,
+        QOrientationReading::TopDown,
+        QOrientationReading::LeftUp,
+        QOrientationReading::RightUp,
+    };
+
+    Result result;
+    for (int i = 0; i < events; i++) {
+        m_harness->osd().answer = actions[m_random.bounded(int(actions.size()))];
+
+        if (m_random.bounded(3) == 0) {
+            auto const orientation = orientations[m_random.bounded(int(orientations.size()))];
+            m_harness->orientationSensor()->setReading(orientation);
+            result.orientations++;
+        } else {
+            m_harness->hotplug(m_configs[m_random.bounded(int(m_configs.size()))]->clone());
+            result.hotplugs++;
+        }
+
+        // Now and then let OSD replies and finished applies come in between the events.
+        if (m_random.bounded(4) == 0) {
+            QCoreApplication::processEvents();
+        }
+    }
+    return result;
+}
+
+void TestStorm::storm()
+{
+    auto const events = qEnvironmentVariableIsSet("KDISPLAY_STORM_EVENTS")
+        ? qEnvironmentVariableIntValue("KDISPLAY_STORM_EVENTS")
+        : default_events;
+
+    auto const counter = [this](char const* name) {
+        return m_harness->counter(QString::fromLatin1(name));
+    };
+    auto const watchers = [this] {
+        // Finished watchers are deleted later.
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        return m_harness->daemon()->findChildren<QDBusPendingCallWatcher*>().size();
+    };
+
+    // The first round warms up allocations, the second one must not need more memory.
+    qint64 rss = 0;
+    for (int round = 0; round < 2; round++) {
+        auto const applies = counter("applies");
+        auto const requests = counter("osdRequests");
+
+        auto const result = runStorm(events);
+
+        // The apply queue drains: everything started finishes, and nothing more happens
+        // afterwards. No watcher of an OSD request is left behind either, so every reply arrived.
+        QVERIFY(m_harness->settle(30000));
+        QTRY_COMPARE_WITH_TIMEOUT(watchers(), qsizetype(0), 10000);
+        QVERIFY(m_harness->settle());
+
+        auto const settled = counter("applies");
+        QTest::qWait(200);
+        QCOMPARE(counter("applies"), settled);
+
+        // Each OSD reply applies at most once and orientation changes while an apply is in
+        // flight are coalesced into a single queued apply.
+        auto const roundApplies = settled - applies;
+        auto const roundRequests = counter("osdRequests") - requests;
+        QVERIFY2(roundApplies <= roundRequests + result.orientations,
+                 qPrintable(QStringLiteral("%1 applies for %2 OSD requests and %3 orientations")
+                                .arg(roundApplies)
+                                .arg(roundRequests)
+                                .arg(result.orientations)));
+
+        qInfo().nospace() << "Round " << round << ": " << result.hotplugs << " hotplugs, "
+                          << result.orientations << " orientation changes, " << roundRequests
+                          << " OSD requests, " << roundApplies << " applies ("
+                          << counter("reapplies") << " re-applies in total)";
+
+        auto const current = procStatus("VmRSS");
+        if (round == 1 && rss > 0 && current > 0) {
+            QVERIFY2(current - rss < 16 * 1024 * 1024,
+                     qPrintable(
+                         QStringLiteral("RSS grew from %1 to %2 bytes").arg(rss).arg(current)));
+        }
+        rss = current;
+    }
+
+    QCOMPARE(counter("failedApplies"), 0u);
+    qInfo() << "Total applies:" << counter("applies") << "Peak RSS:" << procStatus("VmHWM") / 1024
+            << "KiB";
+}
+
+QTEST_GUILESS_MAIN(TestStorm)
+
+#include "teststorm.moc"
@@ -0,0 +1,221 @@
+/*
+    SPDX-FileCopyrightText: 2014-2016 Sebastian Kügler <sebas@kde.org>
+    SPDX-FileCopyrightText: 2022 David Redondo <kde@david-redondo.de>
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../plasma-integration/osd/osdaction.h"
+#include "../../plasma-integration/osd/osdmanager.h"
+#include "osdservice_interface.h"
+
+#include <QDBusConnection>
+#include <QDBusPendingCallWatcher>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QProcess>
+#include <QQuickItem>
+#include <QQuickView>
+#include <QScreen>
+#include <QTimer>
+#include <QtTest>
+
+#include <algorithm>
+#include <memory>
+
+static int const warm_runs = 10;
+
+/**
+ * Measures how long kded waits for the OSD: from the showActionSelector call until the selector
+ * rendered its first frame and until the reply with the selected action arrived. The service
+ * runs in-process on a private session bus and is called over that bus. The first request is
+ * cold, the following ones reuse the view.
+ *
+ * kded passes the output to show on with showActionSelectorOn. When that matches a screen the OSD
+ * knows, it shows up without fetching the config first, which is measured warm as well.
+ */
+class OsdRoundTripBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void roundTrip_data();
+    void roundTrip();
+
+private:
+    struct Sample {
+        qint64 visible{-1};
+        qint64 reply{-1};
+    };
+    Sample request(QScreen* screen = nullptr);
+
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+    QProcess m_bus;
+    QString m_address;
+    std::unique_ptr<KDisplay::OsdManager> m_manager;
+    std::unique_ptr<OrgKwinftKdisplayOsdServiceInterface> m_osd;
+
+    QElapsedTimer m_timer;
+    QEventLoop* m_loop{nullptr};
+    QQuickView* m_view{nullptr};
+    Sample m_sample;
+
+    Sample m_cold;
+    Sample m_warm;
+    Sample m_warmOn;
+};
+
+void OsdRoundTripBenchmark::initTestCase()
+{
+    m_bus.start(QStringLiteral("dbus-daemon"),
+                {QStringLiteral("--session"),
+                 QStringLiteral("--nofork"),
+                 QStringLiteral("--print-address")});
+    if (!m_bus.waitForStarted() || !m_bus.waitForReadyRead()) {
+        QSKIP("Cannot start a private session bus");
+    }
+    m_address = QString::fromUtf8(m_bus.readLine().trimmed());
+    qputenv("DBUS_SESSION_BUS_ADDRESS", m_address.toUtf8());
+
+    m_manager = std::make_unique<KDisplay::OsdManager>();
+
+    // Call over the bus from a second connection, as kded does.
+    auto client = QDBusConnection::connectToBus(m_address, QStringLiteral("client"));
+    QVERIFY(client.isConnected());
+    m_osd = std::make_unique<OrgKwinftKdisplayOsdServiceInterface>(
+        QStringLiteral("org.kwinft.kdisplay.osdService"),
+        QStringLiteral("/org/kwinft/kdisplay/osdService"),
+        client);
+
+    qApp->installEventFilter(this);
+
+    m_cold = request();
+    QVERIFY(m_cold.reply >= 0);
+
+    // Takes the median of the warm runs.
+    auto const warm = [this](QScreen* screen) {
+        std::vector<Sample> samples;
+        for (int i = 0; i < warm_runs; i++) {
+            samples.push_back(request(screen));
+            if (samples.back().reply < 0) {
+                return Sample{};
+            }
+        }
+
+        auto const median = [&samples](auto member) {
+            std::vector<qint64> values;
+            for (auto const& sample : samples) {
+                values.push_back(sample.*member);
+            }
+            std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+            return values[values.size() / 2];
+        };
+        return Sample{median(&Sample::visible), median(&Sample::reply)};
+    };
+
+    m_warm = warm(nullptr);
+    QVERIFY(m_warm.reply >= 0);
+
+    auto const screen = qGuiApp->primaryScreen();
+    QVERIFY(screen);
+    m_warmOn = warm(screen);
+    QVERIFY(m_warmOn.reply >= 0);
+}
+
+void OsdRoundTripBenchmark::cleanupTestCase()
+{
+    qApp->removeEventFilter(this);
+    m_osd.reset();
+    m_manager.reset();
+    QDBusConnection::disconnectFromBus(QStringLiteral("client"));
+
+    m_bus.terminate();
+    m_bus.waitForFinished();
+}
+
+bool OsdRoundTripBenchmark::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() != QEvent::Expose || !m_loop || m_view) {
+        return false;
+    }
+
+    auto view = qobject_cast<QQuickView*>(watched);
+    if (!view || !view->isExposed()) {
+        return false;
+    }
+
+    // Visible means the first frame after the request is on screen.
+    m_view = view;
+    connect(
+        view,
+        &QQuickWindow::frameSwapped,
+        this,
+        [this] {
+            m_sample.visible = m_timer.nsecsElapsed();
+
+            // Select an action like a user would.
+            QMetaObject::invokeMethod(m_view->rootObject(),
+                                      "clicked",
+                                      Q_ARG(int, KDisplay::OsdAction::ExtendRight),
+                                      Q_ARG(int, -1));
+        },
+        Qt::SingleShotConnection);
+    return false;
+}
+
+OsdRoundTripBenchmark::Sample OsdRoundTripBenchmark::request(QScreen* screen)
+{
+    QEventLoop loop;
+    m_loop = &loop;
+    m_view = nullptr;
+    m_sample = {};
+
+    m_timer.start();
+    auto const call = screen ? m_osd->showActionSelectorOn(screen->name(), screen->geometry())
+                             : m_osd->showActionSelector();
+    auto watcher = new QDBusPendingCallWatcher(call, &loop);
+    connect(watcher, &QDBusPendingCallWatcher::finished, &loop, [this, &loop, watcher] {
+        m_sample.reply = m_timer.nsecsElapsed();
+        QDBusPendingReply<int, int> reply = *watcher;
+        if (reply.isError() || reply.value() != KDisplay::OsdAction::ExtendRight) {
+            qWarning() << "Unexpected reply" << reply.error() << reply.value();
+            m_sample.reply = -1;
+        }
+        loop.quit();
+    });
+    QTimer::singleShot(10000, &loop, [&loop] {
+        qWarning() << "OSD request timed out";
+        loop.quit();
+    });
+    loop.exec();
+
+    m_loop = nullptr;
+    return m_sample;
+}
+
+void OsdRoundTripBenchmark::roundTrip_data()
+{
+    QTest::addColumn<qint64>("nsecs");
+
+    QTest::newRow("cold call to visible") << m_cold.visible;
+    QTest::newRow("cold call to reply") << m_cold.reply;
+    QTest::newRow("warm call to visible") << m_warm.visible;
+    QTest::newRow("warm call to reply") << m_warm.reply;
+    QTest::newRow("warm call on screen to visible") << m_warmOn.visible;
+    QTest::newRow("warm call on screen to reply") << m_warmOn.reply;
+}
+
+void OsdRoundTripBenchmark::roundTrip()
+{
+    QFETCH(qint64, nsecs);
+    QVERIFY(nsecs >= 0);
+    QTest::setBenchmarkResult(nsecs / 1000000., QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(OsdRoundTripBenchmark)
+
+#include "benchroundtrip.moc"
@@ -0,0 +1,165 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDisplay Contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "../../plasma-integration/osd/osdmanager.h"
+#include "osdservice_interface.h"
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QProcess>
+#include <QQuickView>
+#include <QTimer>
+#include <QtTest>
+
+static QString const service = QStringLiteral("org.kwinft.kdisplay.osdService");
+static QString const path = QStringLiteral("/org/kwinft/kdisplay/osdService");
+
+static int receivers(QObject* object, char const* signal)
+{
+    // QObject::receivers is protected, reach it through a member pointer taken in a subclass.
+    struct Access : QObject {
+        static auto get()
+        {
+            return &Access::receivers;
+        }
+    };
+    return (object->*Access::get())(signal);
+}
+
+static bool ownsService()
+{
+    auto const bus = QDBusConnection::sessionBus();
+    return bus.interface()->serviceOwner(service).value() == bus.baseService();
+}
+
+static QQuickView* selectorView()
+{
+    auto const windows = QGuiApplication::topLevelWindows();
+    for (auto window : windows) {
+        if (auto view = qobject_cast<QQuickView*>(window)) {
+            return view;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Hammers the OSD service with requests and checks that it doesn't accumulate connections or
+ * objects while doing so. It runs on a private session bus, so it does not clash with the OSD
+ * of a running session.
+ */
+class TestOsdManager : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void churn();
+    void hiddenWhileFetching();
+
+private:
+    QProcess m_bus;
+    QString m_address;
+};
+
+void TestOsdManager::initTestCase()
+{
+    m_bus.start(QStringLiteral("dbus-daemon"),
+                {QStringLiteral("--session"),
+                 QStringLiteral("--nofork"),
+                 QStringLiteral("--print-address")});
+    if (!m_bus.waitForStarted() || !m_bus.waitForReadyRead()) {
+        QSKIP("Cannot start a private session bus");
+    }
+    m_address = QString::fromUtf8(m_bus.readLine().trimmed());
+    qputenv("DBUS_SESSION_BUS_ADDRESS", m_address.toUtf8());
+    QVERIFY(QDBusConnection::sessionBus().isConnected());
+}
+
+void TestOsdManager::cleanupTestCase()
+{
+    m_bus.terminate();
+    m_bus.waitForFinished();
+}
+
+void TestOsdManager::churn()
+{
+    KDisplay::OsdManager manager;
+    QVERIFY(ownsService());
+
+    auto timer = manager.findChild<QTimer*>();
+    QVERIFY(timer);
+    auto const timerReceivers = receivers(timer, SIGNAL(timeout()));
+    auto const children = manager.children().size();
+
+    // Calls must go over the bus, as they would from kded.
+    auto client = QDBusConnection::connectToBus(m_address, QStringLiteral("testosdmanager"));
+    OrgKwinftKdisplayOsdServiceInterface osd(service, path, client);
+
+    QList<QDBusPendingReply<int, int>> replies;
+    for (int i = 0; i < 100; i++) {
+        osd.prepare();
+        replies << osd.showActionSelector();
+        replies << osd.showActionSelectorOn(QStringLiteral("unknown"), QRect(0, 0, 1, 1));
+        if (i % 10 == 0) {
+            osd.hideOsd();
+        }
+    }
+    osd.hideOsd();
+
+    // Superseded and hidden requests are all answered.
+    QTRY_VERIFY_WITH_TIMEOUT(
+        std::all_of(replies.cbegin(), replies.cend(), [](auto const& reply) {
+            return reply.isFinished();
+        }),
+        20000);
+
+    QCOMPARE(receivers(timer, SIGNAL(timeout())), timerReceivers);
+    QCOMPARE(manager.children().size(), children);
+
+    // One selector view that is reused, with at most one pending connection for its first frame.
+    auto const windows = QGuiApplication::topLevelWindows();
+    QVERIFY(std::count_if(windows.cbegin(), windows.cend(), [](auto window) {
+                return qobject_cast<QQuickView*>(window);
+            })
+            <= 1);
+    if (auto view = selectorView()) {
+        QVERIFY(receivers(view, SIGNAL(frameSwapped())) <= 1);
+    }
+
+    QDBusConnection::disconnectFromBus(QStringLiteral("testosdmanager"));
+}
+
+void TestOsdManager::hiddenWhileFetching()
+{
+    KDisplay::OsdManager manager;
+    QVERIFY(ownsService());
+
+    auto client = QDBusConnection::connectToBus(m_address, QStringLiteral("testosdmanager"));
+    OrgKwinftKdisplayOsdServiceInterface osd(service, path, client);
+
+    // Without a daemon the screen comes from a config fetch. Hidden at different points of it,
+    // as kded does on every apply not coming from the OSD, the selector must not show up late.
+    for (int delay = 0; delay < 30; delay += 2) {
+        auto reply = osd.showActionSelectorOn(QStringLiteral("unknown"), QRect(0, 0, 1, 1));
+        QTest::qWait(delay);
+        osd.hideOsd();
+        QTRY_VERIFY(reply.isFinished());
+        QCOMPARE(reply.argumentAt<0>(), int(KDisplay::OsdAction::NoAction));
+        QCOMPARE(reply.argumentAt<1>(), -1);
+    }
+
+    QTest::qWait(500);
+    auto const view = selectorView();
+    QVERIFY(!view || !view->isVisible());
+
+    QDBusConnection::disconnectFromBus(QStringLiteral("testosdmanager"));
+}
+
+QTEST_MAIN(TestOsdManager)
+
+#include "testosdmanager.moc"